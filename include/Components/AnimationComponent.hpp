@@ -15,46 +15,20 @@
 #ifndef NC_COMPONENTS_ANIMATIONCOMPONENT_HPP
 #define NC_COMPONENTS_ANIMATIONCOMPONENT_HPP
 
-#include <SFML/Graphics/Rect.hpp>
-#include <entt/entt.hpp>
-#include <string>
-#include <unordered_map>
+#include <Game/AnimationLibrary.hpp>
+#include <cstdint>
 
 namespace nc {
 
-class AnimationComponent {
-public:
-    AnimationComponent(entt::handle objectHandle,
-                       sf::Vector2i frameSize = sf::Vector2i(16, 32));
-    void setFramerate(float fps);
-    float getFramerate() const;
-    void setFrameSize(sf::Vector2i size);
-    void update(float dt);
-    void addAnimation(const std::string& name, sf::Vector2i firstFrame,
-                      unsigned int frameNo, bool repeated);
-    void startAnimation(const std::string& name, bool force = false);
-    std::string getCurrentAnimation() const;
-
-private:
-    struct AnimationInfo {
-        sf::Vector2i firstFrame;
-        unsigned int frames;
-        bool repeated;
-    };
-
-private:
-    entt::handle m_objectHandle;
-    float m_frameTimestep;
-    float m_accum;
-    unsigned int m_currentFrame;
-    unsigned int m_animFrames;
-    bool m_shouldRepeat;
-    sf::IntRect m_frameRect;
-    std::unordered_map<std::string, AnimationInfo> m_animations;
-    std::string m_currentAnim;
-    std::string m_requestedAnim;
+// Playback state only, the clips live in the AnimationLibrary and
+// AnimationSystem advances them
+struct AnimationComponent {
+    ClipId clip      = AnimationLibrary::NO_CLIP; // Clip being played
+    ClipId requested = AnimationLibrary::NO_CLIP; // Played once clip ends
+    std::uint16_t frame = 0;
+    float accum         = 0.0f; // Time the current frame has been shown
 };
 
 }
 
-#endif // !NC_COMPONENTS_ANIMATIONCOMPONENT_HPP
\ No newline at end of file
+#endif // !NC_COMPONENTS_ANIMATIONCOMPONENT_HPP
@@ -0,0 +1,34 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_COMPONENTS_DROPPEDITEMCOMPONENT_HPP
+#define NC_COMPONENTS_DROPPEDITEMCOMPONENT_HPP
+
+#include <Game/ItemStack.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+
+namespace nc {
+
+// Loose stack lying in the world, maintained by ItemDrops
+struct DroppedItemComponent {
+    ItemStack stack;
+    sf::Vector2f pos; // World position of the stack's center
+    std::uint64_t despawnTick = 0; // Despawn timer still in effect
+    std::uint64_t pickupTick  = 0; // First tick players can pick it up
+};
+
+}
+
+#endif // !NC_COMPONENTS_DROPPEDITEMCOMPONENT_HPP
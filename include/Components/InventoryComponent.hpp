@@ -1,11 +1,11 @@
 // Copyright 2021 Sirbu Dan
-// 
+//
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at
-// 
+//
 //     http://www.apache.org/licenses/LICENSE-2.0
-// 
+//
 // Unless required by applicable law or agreed to in writing, software
 // distributed under the License is distributed on an "AS IS" BASIS,
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
@@ -16,18 +16,45 @@
 #define NC_COMPONENTS_INVENTORYCOMPONENT_HPP
 
 #include <Game/ItemStack.hpp>
+#include <array>
 
 namespace nc {
 
+// Slots stored inline up to a fixed capacity, so entt can copy and relocate
+// the component like any other value and no operation allocates. Operations
+// returning bool change nothing when they fail, the others move as many
+// items as fit and return how many did.
 class InventoryComponent {
 public:
-    explicit InventoryComponent(unsigned int size);
-    ~InventoryComponent();
+    static constexpr unsigned int CAPACITY = 45;
 
-    ItemStack* inventory;
-    unsigned int size;
+public:
+    explicit InventoryComponent(unsigned int size = CAPACITY);
+    unsigned int getSize() const;
+    ItemStack& getSlot(unsigned int slot);
+    const ItemStack& getSlot(unsigned int slot) const;
+    unsigned int getCount(const Item* item) const;
+    // Room for the item in its unfilled stacks and the empty slots
+    unsigned int getSpace(const Item* item) const;
+    // Tops up stacks of the item before using empty slots
+    unsigned int insert(Item* item, unsigned int count);
+    bool insertAll(Item* item, unsigned int count);
+    // Takes from the last stacks of the item first
+    unsigned int remove(const Item* item, unsigned int count);
+    bool removeAll(const Item* item, unsigned int count);
+    // Moves part of a stack to an empty slot or a stack of the same item
+    bool split(unsigned int from, unsigned int to, unsigned int count);
+    // Moves items of one slot into another inventory, merging with its stacks
+    unsigned int moveTo(unsigned int slot, InventoryComponent& to,
+                        unsigned int count);
+    // Moves up to max items of any kind into another inventory
+    unsigned int transferTo(InventoryComponent& to, unsigned int max);
+
+private:
+    std::array<ItemStack, CAPACITY> m_slots;
+    unsigned int m_size; // Slots in use, the rest stay empty
 };
 
 }
 
-#endif // !NC_COMPONENTS_INVENTORYCOMPONENT_HPP
\ No newline at end of file
+#endif // !NC_COMPONENTS_INVENTORYCOMPONENT_HPP
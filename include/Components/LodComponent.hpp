@@ -0,0 +1,32 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_COMPONENTS_LODCOMPONENT_HPP
+#define NC_COMPONENTS_LODCOMPONENT_HPP
+
+#include <cstdint>
+
+namespace nc {
+
+// Simulation level of detail, maintained by SimulationLod
+struct LodComponent {
+    double lastStep   = 0.0;  // Simulated time of the last step
+    float step        = 0.0f; // Seconds to simulate this tick, 0 if skipped
+    std::uint8_t tier = 0;    // 0 is stepped every tick
+    bool visible      = true; // Cosmetic updates are skipped if not
+};
+
+}
+
+#endif // !NC_COMPONENTS_LODCOMPONENT_HPP
@@ -15,9 +15,15 @@
 #ifndef NC_COMPONENTS_PLAYERINPUTCOMPONENT_HPP
 #define NC_COMPONENTS_PLAYERINPUTCOMPONENT_HPP
 
+#include <General/ActionMap.hpp>
+
 namespace nc {
 
-struct PlayerInputComponent {};
+struct PlayerInputComponent {
+    ActionSet held;     // Actions whose key is down
+    ActionSet pressed;  // Actions that went down since the last tick
+    ActionSet released; // Actions that went up since the last tick
+};
 
 }
 
@@ -0,0 +1,57 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_ANIMATIONLIBRARY_HPP
+#define NC_GAME_ANIMATIONLIBRARY_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nc {
+
+using ClipId = std::uint16_t;
+
+struct AnimationClip {
+    sf::Vector2i firstFrame; // Texture position of the first frame
+    sf::Vector2i frameSize;
+    unsigned int frames;
+    float frameTime; // Seconds each frame is shown
+    bool repeated;
+};
+
+// Every animation clip of the game, loaded once from data files and
+// referenced by id. Clips are named "<set>.<clip>", e.g. "player.idle".
+class AnimationLibrary {
+public:
+    static constexpr ClipId NO_CLIP = 0xffff;
+
+public:
+    // Ids are never reused, adding a clip again replaces it under its old id
+    ClipId add(const std::string& name, const AnimationClip& clip);
+    // NO_CLIP if there is no such clip, resolve once and keep the id
+    ClipId getId(const std::string& name) const;
+    const AnimationClip& get(ClipId id) const;
+    std::size_t getClipNo() const;
+
+private:
+    std::vector<AnimationClip> m_clips;
+    std::unordered_map<std::string, ClipId> m_ids;
+};
+
+}
+
+#endif // !NC_GAME_ANIMATIONLIBRARY_HPP
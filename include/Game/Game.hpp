@@ -16,27 +16,55 @@
 #define NC_GAME_GAME_HPP
 
 #include <General/TextureAtlas.hpp>
+#include <General/FramePacer.hpp>
+#include <General/LogConsole.hpp>
+#include <General/ActionMap.hpp>
+#include <General/ThreadPool.hpp>
+#include <General/PhaseTimer.hpp>
 #include <Game/GameState.hpp>
 #include <Game/GameRegistry.hpp>
+#include <Game/AnimationLibrary.hpp>
+#include <Game/LaunchOptions.hpp>
+#include <Game/Settings.hpp>
+#include <Game/Replay.hpp>
 #include <SFML/Graphics.hpp>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
-#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/sinks/dup_filter_sink.h>
 #include <entt/entt.hpp>
-#include <sstream>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace nc {
 
 class Game {
 public:
     static constexpr float TIMESTEP = 1.0f / 60.0f;
+    static constexpr unsigned int MAX_CATCHUP_TICKS = 5;
+    static constexpr float TICK_BUDGET              = TIMESTEP * 0.75f;
+    static constexpr std::size_t LOG_QUEUE_SIZE     = 8192;
+    static constexpr std::size_t LOG_FILE_SIZE      = 5 * 1024 * 1024;
+    static constexpr std::size_t LOG_FILE_NO        = 3;
+    static constexpr const char* ASSET_PACK_PATH    = "data/base.ncpack";
+    static constexpr const char* ASSET_CACHE_DIR    = "cache/assets";
+    static constexpr unsigned int FLUID_BENCH_CHUNKS    = 16; // Per side
+    static constexpr unsigned int FLUID_BENCH_SPACING   = 8; // Between sources
+    static constexpr std::size_t FLUID_BENCH_MAX_STEPS  = 10000;
+
+public:
+    using SettingsListener = std::function<void(const Settings&)>;
 
 public:
     Game(int argc, char** argv);
-    void run();
-    const nlohmann::json& getSettings() const;
+    ~Game();
+    int run();
+    const Settings& getSettings() const;
+    void setSettings(const Settings& settings);
+    unsigned int addSettingsListener(SettingsListener listener);
+    void removeSettingsListener(unsigned int id);
     void saveSettings();
+    const ActionMap& getActionMap() const;
     TextureAtlas& getTextureAtlas();
     sf::View& getView();
     void setTimeScale(float scale);
@@ -45,41 +73,78 @@ public:
     GameState* getState() const;
     sf::RenderWindow& getWindow();
     GameRegistry& getRegistry();
+    AnimationLibrary& getAnimations();
+    ThreadPool& getThreadPool();
+    const LaunchOptions& getLaunchOptions() const;
+    // Empty when the asset cache is disabled
+    std::string getAssetCacheDir() const;
+    bool isHeadless() const;
+    bool isDeterministic() const;
+    bool isTickOverBudget() const;
+    void deferWork();
+    unsigned long getDroppedTicks() const;
+    unsigned long getDeferredTicks() const;
+    // Ends the current launch phase, until the main menu is first drawn
+    void markStartupPhase(const std::string& name);
 
     static Game* getInstance();
 
 private:
     void setup();
     void execute();
+    void executeHeadless();
+    bool executeReplay();
+    bool executeFluidBench();
+    void tick(float dt);
+    void switchState();
     void loadSettings();
-    void createDefaultSettings();
-    void loadTextures();
-    void loadItems();
-    void loadTiles();
+    void applySettings(const Settings& settings);
+    void loadAssets();
+    bool loadAssetPack();
+    void finishStartup();
 
 private:
     static Game* m_inst; // Game instance
 
+    PhaseTimer m_startup; // Launch phases up to the first main menu frame
+    bool m_startupDone;
+
     int m_argc;
     char** m_argv;
+    LaunchOptions m_options; // Command line options
     bool m_drawConsole;
 
     GameState* m_gameState; // Game state object
     GameState* m_requestedState; // Requested game state
     GameRegistry m_reg; // Game registry
+    AnimationLibrary m_animations; // Animation clips of every entity
 
-    nlohmann::json m_settings;
+    Settings m_settings;
+    std::vector<std::pair<unsigned int, SettingsListener>> m_listeners;
+    unsigned int m_nextListener;
+    ActionMap m_actions; // Key bindings built from the control settings
+    ReplayWriter m_recorder; // Records the first world of the session
+    ThreadPool m_pool; // Workers for loading and simulation jobs
     
-    std::ostringstream m_logData; // Log data stream
-    std::shared_ptr<spdlog::sinks::ostream_sink_mt> m_sink; // Log sink
+    std::shared_ptr<LogConsole> m_console; // Log sink shown in the console
+    std::shared_ptr<spdlog::sinks::dup_filter_sink_mt> m_sinks; // All sinks
+    LogStreamBuf m_sfmlErr; // Forwards sf::err() to the log
     std::shared_ptr<spdlog::logger> m_logger; // Logger
 
     sf::Clock m_delta; // Delta time clock
+    FramePacer m_pacer; // Frame rate limiter
     TextureAtlas m_atlas; // Texture atlas
 
-    sf::RenderWindow m_win; // Game window
+    std::unique_ptr<sf::RenderWindow> m_win; // Game window, null if headless
     sf::View m_view; // Main camera
     float m_timeScale; // Game time scale
+
+    sf::Clock m_tickClock; // Time spent in the current tick
+    sf::Clock m_catchupClock; // Time spent simulating in the current frame
+    bool m_catchingUp; // Whether this frame already ran a tick
+    bool m_tickDeferred; // Whether the current tick deferred any work
+    unsigned long m_droppedTicks; // Ticks skipped by the catch-up cap
+    unsigned long m_deferredTicks; // Ticks that shed deferrable work
 };
 
 }
@@ -16,12 +16,23 @@
 #define NC_GAMEREGISTRY_HPP
 
 #include <unordered_map>
+#include <functional>
 #include <string>
 
 namespace nc {
 
 class Item;
 class Tile;
+class Prefab;
+class Map;
+
+// Tile callbacks run by the map's TileTicks, given the tile's global position
+struct TileBehaviour {
+    using Tick = std::function<void(Map& map, unsigned int x, unsigned int y)>;
+
+    Tick randomTick; // Runs on a few random tiles of every chunk each tick
+    Tick scheduledTick; // Runs when a delay from TileTicks::schedule expires
+};
 
 class GameRegistry {
 public:
@@ -29,12 +40,19 @@ public:
     ~GameRegistry();
     void registerItem(Item* item);
     void registerTile(Tile* tile);
+    void registerPrefab(Prefab* prefab);
+    // Tiles placed from now on tick with the behaviour
+    void registerTileBehaviour(const std::string& tile,
+                               TileBehaviour behaviour);
     Item* getItem(const std::string& name);
     Tile* getTile(const std::string& name);
+    Prefab* getPrefab(const std::string& name);
 
 private:
     std::unordered_map<std::string, Item*> m_items;
     std::unordered_map<std::string, Tile*> m_tiles;
+    std::unordered_map<std::string, Prefab*> m_prefabs;
+    std::unordered_map<std::string, TileBehaviour> m_behaviours;
 };
 
 }
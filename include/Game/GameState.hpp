@@ -20,6 +20,8 @@
 
 namespace nc {
 
+class Tile;
+
 class GameState {
 public:
     virtual ~GameState();
@@ -27,6 +29,10 @@ public:
     virtual void handleEvent(sf::Event e)    = 0;
     virtual void update(float dt)            = 0;
     virtual void draw(sf::RenderWindow& win) = 0;
+    virtual bool isIdle() const;
+    // Called after an asset changed on disk was reloaded
+    virtual void onTextureReloaded(const sf::Texture& texture);
+    virtual void onTileReloaded(Tile* tile);
 };
 
 }
@@ -20,6 +20,9 @@
 namespace nc {
 
 class ItemStack {
+public:
+    static constexpr unsigned int MAX_COUNT = 64;
+
 public:
     ItemStack();
     void setItem(Item* item, unsigned int count = 1);
@@ -0,0 +1,39 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_LAUNCHOPTIONS_HPP
+#define NC_GAME_LAUNCHOPTIONS_HPP
+
+#include <string>
+
+namespace nc {
+
+struct LaunchOptions {
+    static LaunchOptions parse(int argc, char** argv);
+
+    bool headless     = false; // Simulate without a window or GL context
+    float tickRate    = 60.0f; // Headless ticks per second, 0 is unthrottled
+    float duration    = 0.0f;  // Headless simulated seconds, 0 runs forever
+    float walkSpeed   = 0.0f;  // Headless player speed in tiles per second
+    bool noPack       = false; // Ignore data/base.ncpack and decode the zip
+    bool noCache      = false; // Decode every asset instead of using the cache
+    bool startupBench = false; // Print startup timings at the menu and exit
+    bool fluidBench   = false; // Time flooding a large area headless and exit
+    std::string recordPath; // Replay file to record the session into
+    std::string replayPath; // Replay file to play back headless
+};
+
+}
+
+#endif // !NC_GAME_LAUNCHOPTIONS_HPP
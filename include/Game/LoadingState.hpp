@@ -0,0 +1,47 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_LOADINGSTATE_HPP
+#define NC_GAME_LOADINGSTATE_HPP
+
+#include <Game/GameState.hpp>
+#include <General/AssetLoader.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/View.hpp>
+
+namespace nc {
+
+// Shows a progress bar while assets load, then opens the main menu
+class LoadingState : public GameState {
+public:
+    static constexpr float FRAME_BUDGET = 1.0f / 120.0f;
+
+public:
+    LoadingState();
+    void perFrame() override;
+    void handleEvent(sf::Event e) override;
+    void update(float dt) override;
+    void draw(sf::RenderWindow& win) override;
+
+private:
+    AssetLoader m_loader;
+    sf::View m_view;
+    sf::RectangleShape m_back;
+    sf::RectangleShape m_bar;
+    bool m_done;
+};
+
+}
+
+#endif // !NC_GAME_LOADINGSTATE_HPP
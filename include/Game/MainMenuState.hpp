@@ -27,6 +27,7 @@ public:
     void handleEvent(sf::Event e) override;
     void update(float dt) override;
     void draw(sf::RenderWindow& win) override;
+    bool isIdle() const override;
 
 private:
     MainMenu m_mainMenu;
@@ -16,6 +16,7 @@
 #define NC_GAME_PLAYINGSTATE_HPP
 
 #include <Game/GameState.hpp>
+#include <Game/Replay.hpp>
 #include <UI/PlayerUI.hpp>
 #include <UI/PlayerInventory.hpp>
 #include <World/Map.hpp>
@@ -32,6 +33,15 @@ public:
     void handleEvent(sf::Event e) override;
     void update(float dt) override;
     void draw(sf::RenderWindow& win) override;
+    void onTextureReloaded(const sf::Texture& texture) override;
+    void onTileReloaded(Tile* tile) override;
+    entt::handle getPlayer();
+    TickInput getTickInput() const;
+    void setTickInput(const TickInput& input);
+    std::uint64_t getStateHash() const;
+
+private:
+    void applyEdit(const WorldEdit& edit);
 
 private:
     OverworldGenerator* m_gen;
@@ -39,6 +49,8 @@ private:
     entt::entity m_player;
     PlayerUI m_playerUI;
     PlayerInventory m_playerInventory;
+    std::vector<WorldEdit> m_edits; // Applied by the next tick
+    std::uint64_t m_editHash; // Hash of every tile changed by edits
 };
 
 }
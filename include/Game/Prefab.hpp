@@ -0,0 +1,57 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_PREFAB_HPP
+#define NC_GAME_PREFAB_HPP
+
+#include <General/AssetDefs.hpp>
+#include <General/Object.hpp>
+#include <Components/AnimationComponent.hpp>
+#include <Components/InventoryComponent.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <entt/entt.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nc {
+
+// Spawn recipe compiled from a prefab definition. The texture and clip are
+// resolved once and every component is built as a prototype, so spawning
+// only copies them into the registry, one batch per component type.
+class Prefab {
+public:
+    explicit Prefab(const PrefabDef& def);
+    const std::string& getName() const;
+    entt::entity spawn(entt::registry& reg, sf::Vector2f pos) const;
+    // Creates count entities at once, one at each position, written to out
+    void spawn(entt::registry& reg, const sf::Vector2f* positions,
+               std::size_t count, entt::entity* out) const;
+
+private:
+    bool has(PrefabDef::Component component) const;
+
+private:
+    std::string m_name;
+    std::uint32_t m_components; // Bit set of PrefabDef::Component
+    Object m_object; // Prototype with texture, size and first frame set
+    AnimationComponent m_animation;
+    sf::FloatRect m_box; // Collision box relative to the position
+    InventoryComponent m_inventory;
+    float m_steeringSpeed;
+};
+
+}
+
+#endif // !NC_GAME_PREFAB_HPP
@@ -0,0 +1,79 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_REPLAY_HPP
+#define NC_GAME_REPLAY_HPP
+
+#include <Game/Settings.hpp>
+#include <General/ActionMap.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+// World change requested by the player, applied at the start of a tick
+struct WorldEdit {
+    enum class Type : std::uint8_t { PlaceTile, AddItem };
+
+    Type type;
+    std::uint8_t slot; // Hotbar slot in use
+    sf::Vector2f pos;  // World position
+};
+
+// Everything a tick of PlayingState consumes besides the world itself
+struct TickInput {
+    float dt = 0.0f;
+    ActionSet held;
+    ActionSet pressed;
+    ActionSet released;
+    std::vector<WorldEdit> edits;
+};
+
+// Replay file layout, all values in native byte order:
+//   header: magic, version, seed, settings JSON size, settings JSON
+//   per tick: dt, held, pressed, released, edit count, edits, state hash
+class ReplayWriter {
+public:
+    static constexpr std::uint32_t MAGIC   = 0x5052434e; // "NCRP"
+    static constexpr std::uint32_t VERSION = 2;
+
+public:
+    bool open(const std::string& path, const Settings& settings);
+    void close();
+    bool isOpen() const;
+    void write(const TickInput& input, std::uint64_t hash);
+    unsigned long getTicks() const;
+
+private:
+    std::ofstream m_out;
+    unsigned long m_ticks = 0;
+};
+
+class ReplayReader {
+public:
+    explicit ReplayReader(const std::string& path);
+    const Settings& getSettings() const;
+    bool read(TickInput& input, std::uint64_t& hash);
+
+private:
+    std::ifstream m_in;
+    Settings m_settings;
+};
+
+}
+
+#endif // !NC_GAME_REPLAY_HPP
@@ -0,0 +1,64 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GAME_SETTINGS_HPP
+#define NC_GAME_SETTINGS_HPP
+
+#include <SFML/Window/Keyboard.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace nc {
+
+enum class WindowType { Window, Fullscreen, Borderless };
+
+struct DisplaySettings {
+    unsigned int resolutionX = 1280;
+    unsigned int resolutionY = 720;
+    WindowType windowType    = WindowType::Window;
+    bool vsync               = false;
+    unsigned int fpsCap      = 144; // 0 is uncapped
+    unsigned int idleFps     = 15;  // Cap in menus and when unfocused
+};
+
+struct ControlSettings {
+    sf::Keyboard::Key toggleConsole   = sf::Keyboard::Tilde;
+    sf::Keyboard::Key moveUp          = sf::Keyboard::W;
+    sf::Keyboard::Key moveDown        = sf::Keyboard::S;
+    sf::Keyboard::Key moveLeft        = sf::Keyboard::A;
+    sf::Keyboard::Key moveRight       = sf::Keyboard::D;
+    sf::Keyboard::Key sprint          = sf::Keyboard::LShift;
+    sf::Keyboard::Key sneak           = sf::Keyboard::LControl;
+    sf::Keyboard::Key toggleInventory = sf::Keyboard::E;
+};
+
+struct DebugSettings {
+    unsigned int testSeed     = 7582;
+    float metricsDumpInterval = 0.0f; // Seconds, 0 disables dumping
+    std::string metricsDumpPath = "metrics.csv";
+};
+
+// Decoded settings.json, missing or invalid values keep their defaults
+struct Settings {
+    static Settings fromJson(const nlohmann::json& j);
+    nlohmann::json toJson() const;
+
+    DisplaySettings display;
+    ControlSettings controls;
+    DebugSettings debug;
+};
+
+}
+
+#endif // !NC_GAME_SETTINGS_HPP
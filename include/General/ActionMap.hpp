@@ -0,0 +1,61 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ACTIONMAP_HPP
+#define NC_GENERAL_ACTIONMAP_HPP
+
+#include <SFML/Window/Keyboard.hpp>
+#include <array>
+#include <bitset>
+#include <cstddef>
+
+namespace nc {
+
+struct ControlSettings;
+
+enum class Action : unsigned int {
+    MoveUp,
+    MoveDown,
+    MoveLeft,
+    MoveRight,
+    Sprint,
+    Sneak,
+    ToggleInventory,
+    ToggleConsole,
+    Count,
+    None = Count
+};
+
+constexpr std::size_t ACTION_NO = static_cast<std::size_t>(Action::Count);
+
+using ActionSet = std::bitset<ACTION_NO>;
+
+// Two way binding between keys and actions, one key per action
+class ActionMap {
+public:
+    ActionMap();
+    explicit ActionMap(const ControlSettings& controls);
+
+    void bind(Action action, sf::Keyboard::Key key);
+    sf::Keyboard::Key getKey(Action action) const;
+    Action getAction(sf::Keyboard::Key key) const;
+
+private:
+    std::array<Action, sf::Keyboard::KeyCount> m_actions; // Indexed by key
+    std::array<sf::Keyboard::Key, ACTION_NO> m_keys; // Indexed by action
+};
+
+}
+
+#endif // !NC_GENERAL_ACTIONMAP_HPP
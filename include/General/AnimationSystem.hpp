@@ -0,0 +1,44 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ANIMATIONSYSTEM_HPP
+#define NC_GENERAL_ANIMATIONSYSTEM_HPP
+
+#include <Game/AnimationLibrary.hpp>
+#include <entt/entt.hpp>
+
+namespace nc {
+
+class Object;
+struct AnimationComponent;
+
+class AnimationSystem {
+public:
+    // Switches to the clip right away if forced or nothing is playing,
+    // otherwise once the current clip reaches its end
+    static void play(entt::handle entity, ClipId clip, bool force = false);
+    // Advances visible animations by their LOD step, only the players' while
+    // deferred
+    static void update(entt::registry& reg, bool deferred);
+
+private:
+    static void step(AnimationComponent& ac, Object& obj,
+                     const AnimationLibrary& lib, float dt);
+    static void showFrame(const AnimationComponent& ac, Object& obj,
+                          const AnimationClip& clip);
+};
+
+}
+
+#endif // !NC_GENERAL_ANIMATIONSYSTEM_HPP
@@ -0,0 +1,61 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ARENA_HPP
+#define NC_GENERAL_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace nc {
+
+// Bump allocator handing out memory from large blocks, all released at once.
+// Nothing is destroyed on release, owners destroy what needs it first.
+class Arena {
+public:
+    static constexpr std::size_t MAX_ALIGN = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+public:
+    explicit Arena(std::size_t blockSize = 1 << 20);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    // Allocations bigger than the block size get a block of their own
+    void* allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t));
+    void release();
+    std::size_t getUsed() const;
+    std::size_t getReserved() const;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(alignof(T) <= MAX_ALIGN, "Over-aligned arena object");
+        return new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+
+private:
+    std::size_t m_blockSize;
+    std::vector<std::unique_ptr<unsigned char[]>> m_blocks;
+    unsigned char* m_pos; // Next free byte of the last block
+    unsigned char* m_end; // End of the last block
+    std::size_t m_used;
+    std::size_t m_reserved;
+};
+
+}
+
+#endif // !NC_GENERAL_ARENA_HPP
@@ -0,0 +1,83 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ASSETCACHE_HPP
+#define NC_GENERAL_ASSETCACHE_HPP
+
+#include <General/AssetDefs.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+// On disk store of products derived from asset files, keyed by a hash of
+// the source path and bytes, so unchanged files skip decoding and parsing on
+// the next launch. Safe to use from several threads, failures only cost a
+// cache miss.
+class AssetCache {
+public:
+    static constexpr std::uint32_t MAGIC   = 0x4341434e; // "NCAC"
+    static constexpr std::uint32_t VERSION = 2; // Bump when a product changes
+
+public:
+    static std::uint64_t getKey(const std::string& path, const char* data,
+                                std::size_t size);
+
+public:
+    explicit AssetCache(const std::string& dir);
+    bool load(std::uint64_t key, sf::Image& img);
+    bool load(std::uint64_t key, TileDef& def);
+    bool load(std::uint64_t key, ItemDef& def);
+    bool load(std::uint64_t key, AnimationSetDef& def);
+    bool load(std::uint64_t key, PrefabDef& def);
+    void store(std::uint64_t key, const sf::Image& img);
+    void store(std::uint64_t key, const TileDef& def);
+    void store(std::uint64_t key, const ItemDef& def);
+    void store(std::uint64_t key, const AnimationSetDef& def);
+    void store(std::uint64_t key, const PrefabDef& def);
+    std::size_t getHits() const;
+    std::size_t getMisses() const;
+
+private:
+    enum class Kind : std::uint32_t { Image, Tile, Item, AnimationSet, Prefab };
+
+    struct EntryHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t key;
+        Kind kind;
+        std::uint32_t size; // Payload bytes following the header
+    };
+
+private:
+    std::string getPath(std::uint64_t key) const;
+    template <typename T>
+    bool loadEntry(std::uint64_t key, Kind kind, T& out);
+    void storeEntry(std::uint64_t key, Kind kind,
+                    const std::vector<char>& payload);
+
+private:
+    std::string m_dir;
+    bool m_enabled;
+    std::atomic<std::size_t> m_hits;
+    std::atomic<std::size_t> m_misses;
+};
+
+}
+
+#endif // !NC_GENERAL_ASSETCACHE_HPP
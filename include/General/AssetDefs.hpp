@@ -0,0 +1,95 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ASSETDEFS_HPP
+#define NC_GENERAL_ASSETDEFS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+struct TileDef {
+    std::string name;
+    std::string texture;
+    bool collidable = false;
+};
+
+struct ItemDef {
+    std::string name;
+    std::string texture;
+    std::string placeTile; // Empty if the item can't be placed
+};
+
+struct AnimationClipDef {
+    std::string name;
+    int x = 0; // Texture position of the first frame
+    int y = 0;
+    unsigned int frames = 1;
+    bool repeated = true;
+};
+
+// Clips sharing a sprite sheet layout, registered as "<name>.<clip>"
+struct AnimationSetDef {
+    std::string name;
+    int frameWidth  = 16;
+    int frameHeight = 16;
+    float framerate = 1.0f; // Frames per second
+    std::vector<AnimationClipDef> clips;
+};
+
+// Components an entity is spawned with besides its Object, and their
+// initial values
+struct PrefabDef {
+    enum Component : std::uint32_t {
+        Velocity     = 1 << 0,
+        CollisionBox = 1 << 1,
+        Animation    = 1 << 2,
+        Inventory    = 1 << 3,
+        Player       = 1 << 4, // Player and player input components
+        Steering     = 1 << 5,
+    };
+
+    std::string name;
+    std::string texture;
+    unsigned int width  = 1; // Size in tiles
+    unsigned int height = 1;
+    std::uint32_t components = 0; // Bit set of Component
+    std::string clip; // Animation clip played on spawn
+    float boxX      = 0.0f; // Collision box relative to the position
+    float boxY      = 0.0f;
+    float boxWidth  = 1.0f;
+    float boxHeight = 1.0f;
+    unsigned int inventorySize = 0;
+    float steeringSpeed        = 1.0f; // Tiles per second
+};
+
+// Stream the definition files straight into the structs without building a
+// JSON document. Unknown fields are ignored, errors are logged with path.
+bool parseTileDef(const char* data, std::size_t size, const std::string& path,
+                  TileDef& def);
+bool parseItemDef(const char* data, std::size_t size, const std::string& path,
+                  ItemDef& def);
+// Animation sets and prefabs are nested, so they are read through a JSON
+// document
+bool parseAnimationSetDef(const char* data, std::size_t size,
+                          const std::string& path, AnimationSetDef& def);
+bool parsePrefabDef(const char* data, std::size_t size,
+                    const std::string& path, PrefabDef& def);
+
+}
+
+#endif // !NC_GENERAL_ASSETDEFS_HPP
@@ -0,0 +1,98 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ASSETLOADER_HPP
+#define NC_GENERAL_ASSETLOADER_HPP
+
+#include <General/ThreadPool.hpp>
+#include <General/AssetPack.hpp>
+#include <General/AssetDefs.hpp>
+#include <General/AssetCache.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Clock.hpp>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+// Loads textures, tiles, items, animations and prefabs. Files are read and
+// decoded on the thread pool, GPU uploads and registry insertion happen in
+// update(). Decoded products are kept in an AssetCache unless cacheDir is
+// empty.
+class AssetLoader {
+public:
+    // Registers everything in a baked pack on the calling thread
+    static void loadPack(const AssetPack& pack, bool loadTextures);
+    // Re-reads a single changed file, patching the already loaded texture,
+    // tile, item, animation or prefab in place so existing references stay
+    // valid
+    static bool reload(const std::string& path);
+
+public:
+    AssetLoader(ThreadPool& pool, bool loadTextures,
+                const std::string& cacheDir);
+    // Applies finished assets for at most budget seconds, returns true once
+    // everything is loaded
+    bool update(float budget);
+    void finish();
+    float getProgress() const;
+    bool isDone() const;
+
+private:
+    struct DecodedImage {
+        std::string path;
+        sf::Image image;
+    };
+
+    template <typename Def>
+    struct DecodedDef {
+        Def def;
+        bool valid;
+    };
+
+    template <typename Def>
+    using DefParser = bool (*)(const char*, std::size_t, const std::string&,
+                               Def&);
+
+private:
+    template <typename Def>
+    void queueDefs(const char* dir, DefParser<Def> parse,
+                   std::vector<std::future<DecodedDef<Def>>>& out);
+
+private:
+    ThreadPool& m_pool;
+    std::shared_ptr<AssetCache> m_cache; // Shared with jobs still running
+    std::vector<std::future<DecodedImage>> m_textures;
+    std::vector<std::future<DecodedDef<TileDef>>> m_tiles;
+    std::vector<std::future<DecodedDef<ItemDef>>> m_items;
+    std::vector<std::future<DecodedDef<AnimationSetDef>>> m_animations;
+    std::vector<std::future<DecodedDef<PrefabDef>>> m_prefabs;
+    std::size_t m_texturesDone; // Uploaded textures
+    std::size_t m_tilesDone; // Registered tiles, in file order
+    std::size_t m_itemsDone; // Registered items, in file order
+    std::size_t m_animationsDone; // Registered animation sets, in file order
+    std::size_t m_prefabsDone; // Registered prefabs, in file order
+    sf::Clock m_clock; // Time since loading started
+#ifdef NC_TRACK_ALLOCATIONS
+    std::uint64_t m_allocations; // Allocation count when loading started
+#endif
+    bool m_reported; // Whether the load time was logged
+};
+
+}
+
+#endif // !NC_GENERAL_ASSETLOADER_HPP
@@ -0,0 +1,138 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ASSETPACK_HPP
+#define NC_GENERAL_ASSETPACK_HPP
+
+#include <General/MappedFile.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nc {
+
+// On-disk layout written by nanocraft-bake, in native byte order. Offsets
+// are relative to the start of the file, strings are offsets into the
+// string table.
+struct PackHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t textureNo;
+    std::uint32_t tileNo;
+    std::uint32_t itemNo;
+    std::uint32_t stringSize;
+    std::uint64_t textureOffset;
+    std::uint64_t tileOffset;
+    std::uint64_t itemOffset;
+    std::uint64_t stringOffset;
+    std::uint32_t clipNo;
+    std::uint32_t prefabNo;
+    std::uint64_t clipOffset;
+    std::uint64_t prefabOffset;
+};
+
+struct PackTexture {
+    std::uint32_t name;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t padding;
+    std::uint64_t pixels; // RGBA8, rows top to bottom
+};
+
+struct PackTile {
+    std::uint32_t name;
+    std::uint32_t texture;
+    std::uint32_t collidable;
+};
+
+struct PackItem {
+    std::uint32_t name;
+    std::uint32_t texture;
+    std::uint32_t placeTile; // NO_STRING if the item can't be placed
+};
+
+struct PackClip {
+    std::uint32_t name; // Full clip name, "<set>.<clip>"
+    std::int32_t x; // Texture position of the first frame
+    std::int32_t y;
+    std::uint32_t frameWidth;
+    std::uint32_t frameHeight;
+    std::uint32_t frames;
+    float frameTime; // Seconds
+    std::uint32_t repeated;
+};
+
+struct PackPrefab {
+    std::uint32_t name;
+    std::uint32_t texture;
+    std::uint32_t clip; // NO_STRING if the prefab isn't animated
+    std::uint32_t components; // Bit set of PrefabDef::Component
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t inventorySize;
+    float steeringSpeed; // Tiles per second
+    float boxX; // Collision box relative to the position
+    float boxY;
+    float boxWidth;
+    float boxHeight;
+};
+
+static_assert(sizeof(PackHeader) == 80, "Pack layout must not change");
+static_assert(sizeof(PackTexture) == 24, "Pack layout must not change");
+static_assert(sizeof(PackTile) == 12, "Pack layout must not change");
+static_assert(sizeof(PackItem) == 12, "Pack layout must not change");
+static_assert(sizeof(PackClip) == 32, "Pack layout must not change");
+static_assert(sizeof(PackPrefab) == 48, "Pack layout must not change");
+
+// Memory mapped asset pack, tables are used in place without parsing
+class AssetPack {
+public:
+    static constexpr std::uint32_t MAGIC     = 0x4b50434e; // "NCPK"
+    static constexpr std::uint32_t VERSION   = 4;
+    static constexpr std::uint32_t NO_STRING = 0xffffffff;
+    static constexpr std::size_t ALIGNMENT   = 16;
+
+public:
+    AssetPack();
+    bool open(const std::string& path);
+    std::uint32_t getTextureNo() const;
+    const PackTexture& getTexture(std::uint32_t i) const;
+    const unsigned char* getPixels(const PackTexture& texture) const;
+    std::uint32_t getTileNo() const;
+    const PackTile& getTile(std::uint32_t i) const;
+    std::uint32_t getItemNo() const;
+    const PackItem& getItem(std::uint32_t i) const;
+    std::uint32_t getClipNo() const;
+    const PackClip& getClip(std::uint32_t i) const;
+    std::uint32_t getPrefabNo() const;
+    const PackPrefab& getPrefab(std::uint32_t i) const;
+    const char* getString(std::uint32_t offset) const;
+
+private:
+    bool validate() const;
+
+private:
+    MappedFile m_file;
+    const PackHeader* m_header;
+    const PackTexture* m_textures;
+    const PackTile* m_tiles;
+    const PackItem* m_items;
+    const PackClip* m_clips;
+    const PackPrefab* m_prefabs;
+    const char* m_strings;
+};
+
+}
+
+#endif // !NC_GENERAL_ASSETPACK_HPP
@@ -0,0 +1,43 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_ASSETWATCHER_HPP
+#define NC_GENERAL_ASSETWATCHER_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nc {
+
+// Reports files written in the asset directories of a data folder. Uses
+// inotify, on other platforms nothing is ever reported.
+class AssetWatcher {
+public:
+    explicit AssetWatcher(const std::string& root);
+    ~AssetWatcher();
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    // Virtual paths, e.g. /textures/grass.png, changed since the last call
+    std::vector<std::string> poll();
+
+private:
+    int m_fd;
+    std::unordered_map<int, std::string> m_dirs; // Watch to virtual dir
+};
+
+}
+
+#endif // !NC_GENERAL_ASSETWATCHER_HPP
@@ -0,0 +1,45 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_FILEREADER_HPP
+#define NC_GENERAL_FILEREADER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+// Reads whole files from the virtual file system into a buffer reused
+// between reads, so it only allocates when a file is larger than any before
+class FileReader {
+public:
+    // Reader owned by the calling thread
+    static FileReader& getLocal();
+
+public:
+    FileReader();
+    // Data stays valid until the next read
+    bool read(const std::string& path);
+    const char* getData() const;
+    std::size_t getSize() const;
+
+private:
+    std::vector<char> m_buffer;
+    std::size_t m_size; // Bytes of the buffer holding the last file
+};
+
+}
+
+#endif // !NC_GENERAL_FILEREADER_HPP
@@ -0,0 +1,55 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_FRAMEPACER_HPP
+#define NC_GENERAL_FRAMEPACER_HPP
+
+#include <chrono>
+#include <array>
+
+namespace nc {
+
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr unsigned int SAMPLE_NO = 120;
+    static constexpr std::chrono::microseconds MIN_SPIN{500};
+    static constexpr std::chrono::microseconds MAX_SPIN{4000};
+
+public:
+    FramePacer();
+    void setTargetFramerate(float fps);
+    float getTargetFramerate() const;
+    void wait();
+    float getFrameTime() const;
+    float getJitter() const;
+    float getMaxJitter() const;
+
+private:
+    void recordFrame(Clock::time_point now);
+
+private:
+    Clock::duration m_period; // Zero when uncapped
+    Clock::time_point m_nextFrame; // Deadline of the next frame
+    Clock::time_point m_lastFrame; // When the last frame was released
+    Clock::duration m_spinMargin; // Time left to spin instead of sleep
+    std::array<float, SAMPLE_NO> m_samples; // Frame times in seconds
+    unsigned int m_sampleCount;
+    unsigned int m_nextSample;
+};
+
+}
+
+#endif // !NC_GENERAL_FRAMEPACER_HPP
@@ -0,0 +1,50 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_HASH_HPP
+#define NC_GENERAL_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace nc {
+
+// 64 bit FNV-1a, stable across runs and platforms of equal endianness
+class Hash {
+public:
+    static constexpr std::uint64_t OFFSET = 14695981039346656037ull;
+    static constexpr std::uint64_t PRIME  = 1099511628211ull;
+
+public:
+    void add(const void* data, std::size_t size);
+    void add(const std::string& str);
+
+    template <typename T>
+    void add(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only plain values can be hashed bytewise");
+        add(&value, sizeof(T));
+    }
+
+    std::uint64_t get() const;
+
+private:
+    std::uint64_t m_value = OFFSET;
+};
+
+}
+
+#endif // !NC_GENERAL_HASH_HPP
@@ -22,8 +22,10 @@ namespace nc {
 
 class InputHandler {
 public:
+    // Folds key events into the action state of every controlled entity
     static void handleInput(const sf::Event& e, entt::registry& reg);
-    static void pollInput(entt::registry& reg);
+    // Applies the action state once per tick, then clears the edges
+    static void processInput(entt::registry& reg);
 };
 
 }
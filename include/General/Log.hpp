@@ -0,0 +1,55 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_LOG_HPP
+#define NC_GENERAL_LOG_HPP
+
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+
+namespace nc {
+
+// Lets a call site through at most once per interval and counts the calls
+// it swallowed in between
+class LogLimiter {
+public:
+    explicit LogLimiter(float interval);
+    bool allow(unsigned int& suppressed);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::duration m_interval;
+    std::atomic<Clock::rep> m_next; // Earliest time the site may log again
+    std::atomic<unsigned int> m_suppressed;
+};
+
+}
+
+// Logs at most once every interval seconds from this call site
+#define NC_LOG_LIMITED(interval, level, ...)                                  \
+    do {                                                                      \
+        static nc::LogLimiter ncLimiter_(interval);                           \
+        unsigned int ncSuppressed_;                                           \
+        if (spdlog::should_log(level) && ncLimiter_.allow(ncSuppressed_)) {   \
+            if (ncSuppressed_ > 0) {                                          \
+                spdlog::log(level, "Suppressed {} messages from {}:{}",       \
+                            ncSuppressed_, __FILE__, __LINE__);               \
+            }                                                                 \
+            spdlog::log(level, __VA_ARGS__);                                  \
+        }                                                                     \
+    } while (false)
+
+#endif // !NC_GENERAL_LOG_HPP
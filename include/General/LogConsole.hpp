@@ -0,0 +1,87 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_LOGCONSOLE_HPP
+#define NC_GENERAL_LOGCONSOLE_HPP
+
+#include <spdlog/sinks/base_sink.h>
+#include <streambuf>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+namespace nc {
+
+// Log sink keeping the most recent lines in fixed size storage, drawn as an
+// ImGui window that only touches the lines currently visible
+class LogConsole : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    static constexpr std::size_t TEXT_CAPACITY = 1 << 20;
+    static constexpr std::size_t LINE_CAPACITY = 1 << 14;
+    static constexpr std::size_t MAX_LINE      = 1024;
+
+public:
+    LogConsole();
+    void draw();
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+    void flush_() override;
+
+private:
+    struct Line {
+        std::uint32_t offset;
+        std::uint32_t length;
+        spdlog::level::level_enum level;
+    };
+
+private:
+    void evictOldest();
+    bool matches(std::uint64_t line) const;
+
+private:
+    std::vector<char> m_text; // Ring of line contents
+    std::vector<Line> m_lines; // Ring of line index entries
+    std::size_t m_writePos;
+    std::uint64_t m_firstLine; // Sequence number of the oldest line
+    std::uint64_t m_nextLine; // Sequence number of the next line
+
+    std::deque<std::uint64_t> m_filtered; // Lines passing the filter
+    std::uint64_t m_filteredUpTo; // Lines checked against the filter
+    char m_filter[128];
+    int m_minLevel;
+    bool m_filterChanged;
+    bool m_autoScroll;
+};
+
+// Stream buffer forwarding every written line to the default logger, for
+// libraries that report errors through a std::ostream
+class LogStreamBuf : public std::streambuf {
+public:
+    explicit LogStreamBuf(std::string prefix);
+
+protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+private:
+    std::string m_prefix;
+    std::string m_line;
+};
+
+}
+
+#endif // !NC_GENERAL_LOGCONSOLE_HPP
@@ -0,0 +1,47 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_MAPPEDFILE_HPP
+#define NC_GENERAL_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace nc {
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    const unsigned char* getData() const;
+    std::size_t getSize() const;
+
+private:
+    const unsigned char* m_data;
+    std::size_t m_size;
+#ifdef _WIN32
+    void* m_file;    // File handle
+    void* m_mapping; // File mapping handle
+#endif
+};
+
+}
+
+#endif // !NC_GENERAL_MAPPEDFILE_HPP
@@ -0,0 +1,82 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_METRICS_HPP
+#define NC_GENERAL_METRICS_HPP
+
+#include <atomic>
+#include <array>
+#include <string>
+#include <cstdint>
+
+namespace nc {
+
+class Counter {
+public:
+    Counter() = default;
+    void add(std::uint64_t n = 1);
+    std::uint64_t get() const;
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+class Gauge {
+public:
+    Gauge() = default;
+    void set(std::int64_t value);
+    void add(std::int64_t n);
+    std::int64_t get() const;
+
+private:
+    std::atomic<std::int64_t> m_value{0};
+};
+
+// Latency histogram with four linear sub-buckets per power of two of
+// microseconds, so percentiles are accurate to within 25%
+class Histogram {
+public:
+    static constexpr unsigned int SUB_BUCKETS = 4;
+    static constexpr unsigned int BUCKET_NO   = 26 * SUB_BUCKETS;
+
+public:
+    Histogram() = default;
+    void record(float seconds);
+    std::uint64_t getCount() const;
+    float getMean() const;
+    float getPercentile(float p) const;
+
+private:
+    static float getUpperBound(unsigned int bucket);
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_NO> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0}; // Microseconds
+};
+
+class Metrics {
+public:
+    static Counter& getCounter(const std::string& name);
+    static Gauge& getGauge(const std::string& name);
+    static Histogram& getHistogram(const std::string& name);
+    static void setDumpInterval(float seconds, const std::string& path);
+    static void update();
+    static bool dump(const std::string& path);
+    static void drawWindow();
+};
+
+}
+
+#endif // !NC_GENERAL_METRICS_HPP
@@ -0,0 +1,51 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_PHASETIMER_HPP
+#define NC_GENERAL_PHASETIMER_HPP
+
+#include <SFML/System/Clock.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace nc {
+
+// Splits a run of work into named phases, each lasting from the end of the
+// previous one, or from construction for the first
+class PhaseTimer {
+public:
+    struct Phase {
+        std::string name;
+        float duration; // Seconds
+        float end; // Seconds since the timer started
+    };
+
+public:
+    PhaseTimer();
+    void mark(const std::string& name);
+    float getElapsed() const;
+    const std::vector<Phase>& getPhases() const;
+    void log(const std::string& title) const;
+    nlohmann::json toJson() const;
+
+private:
+    sf::Clock m_clock;
+    float m_lastMark;
+    std::vector<Phase> m_phases;
+};
+
+}
+
+#endif // !NC_GENERAL_PHASETIMER_HPP
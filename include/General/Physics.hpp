@@ -29,7 +29,8 @@ public:
     static constexpr float VELOCITY_DECEL = 20.0f;
 
 public:
-    static void simulate(entt::registry& reg, float dt, Map* map);
+    // Moves every entity by its LOD step
+    static void simulate(entt::registry& reg, Map* map);
     static void handleWorldCollision(const CollisionBoxComponent* cb,
                                      sf::Vector2f& v, Map* map);
     static void handleChunkCollision(const CollisionBoxComponent* cb,
@@ -0,0 +1,98 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_PROFILER_HPP
+#define NC_GENERAL_PROFILER_HPP
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef NC_PROFILE
+    #define NC_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define NC_PROFILE_CONCAT(a, b)      NC_PROFILE_CONCAT_IMPL(a, b)
+    #define NC_PROFILE_SCOPE(name) \
+        ::nc::ProfileZone NC_PROFILE_CONCAT(ncProfileZone, __LINE__)(name)
+    #define NC_PROFILE_FUNCTION()     NC_PROFILE_SCOPE(__func__)
+    #define NC_PROFILE_FRAME()        ::nc::Profiler::markFrame()
+    #define NC_PROFILE_THREAD(name)   ::nc::Profiler::setThreadName(name)
+#else
+    #define NC_PROFILE_SCOPE(name)    ((void)0)
+    #define NC_PROFILE_FUNCTION()     ((void)0)
+    #define NC_PROFILE_FRAME()        ((void)0)
+    #define NC_PROFILE_THREAD(name)   ((void)0)
+#endif
+
+namespace nc {
+
+struct ProfileSample {
+    const char* name; // Must point to static storage
+    std::int64_t start; // Nanoseconds since profiler start
+    std::int64_t end;
+    std::uint32_t depth; // Nesting level on the owning thread
+};
+
+// Single producer ring buffer, written only by its owning thread and read
+// by the profiler window or the exporter. Old samples are overwritten.
+class ProfileBuffer {
+public:
+    static constexpr std::size_t CAPACITY = 1 << 16;
+
+public:
+    ProfileBuffer(std::uint32_t id, std::string name);
+    void push(const ProfileSample& sample);
+    void snapshot(std::vector<ProfileSample>& out) const;
+    std::uint32_t getId() const;
+    const std::string& getName() const;
+    void setName(const std::string& name);
+
+private:
+    std::array<ProfileSample, CAPACITY> m_samples;
+    std::atomic<std::uint64_t> m_head; // Total samples ever written
+    std::uint32_t m_id;
+    std::string m_name;
+};
+
+class Profiler {
+public:
+    static constexpr std::size_t FRAME_NO = 300;
+
+public:
+    static std::int64_t now();
+    static ProfileBuffer& getThreadBuffer();
+    static void setThreadName(const std::string& name);
+    static void markFrame();
+    static bool exportTrace(const std::string& path);
+    static void drawWindow();
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start;
+    std::uint32_t m_depth;
+};
+
+}
+
+#endif // !NC_GENERAL_PROFILER_HPP
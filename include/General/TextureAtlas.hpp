@@ -16,6 +16,7 @@
 #define NC_GENERAL_TEXTUREATLAS_HPP
 
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <unordered_map>
 #include <filesystem>
@@ -27,8 +28,17 @@ class TextureAtlas {
 public:
     static constexpr unsigned int TILE_SIZE = 16;
 
+public:
+    // Reads and decodes an image without touching the GPU, safe to call
+    // from any thread. Falls back to a placeholder image on failure.
+    static bool decodeImage(const std::string& path, sf::Image& img);
+
 public:
     explicit TextureAtlas();
+    void createDefaultTexture();
+    void addTexture(const std::string& path, const sf::Image& img);
+    void addTexture(const std::string& path, const unsigned char* pixels,
+                    unsigned int width, unsigned int height);
     bool addTexture(const std::filesystem::path& path);
     const sf::Texture& getTexture(const std::string& texture) const;
 
@@ -0,0 +1,68 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_THREADPOOL_HPP
+#define NC_GENERAL_THREADPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nc {
+
+// Fixed set of worker threads running jobs in submission order
+class ThreadPool {
+public:
+    // 0 uses one thread less than the hardware has, leaving one for the
+    // main thread
+    explicit ThreadPool(unsigned int threadNo = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& job) -> std::future<std::invoke_result_t<F>> {
+        using R   = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            std::forward<F>(job));
+        std::future<R> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    // Runs the jobs still queued, then joins every worker
+    void shutdown();
+    unsigned int getThreadNo() const;
+
+private:
+    void enqueue(std::function<void()> job);
+    void work(unsigned int index);
+
+private:
+    std::vector<std::thread> m_threads;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop;
+};
+
+}
+
+#endif // !NC_GENERAL_THREADPOOL_HPP
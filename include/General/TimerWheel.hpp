@@ -0,0 +1,93 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_GENERAL_TIMERWHEEL_HPP
+#define NC_GENERAL_TIMERWHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nc {
+
+// Hashed timer wheel counting in ticks. Timers land in the slot of their due
+// tick, so advancing only looks at one slot; timers due more than a turn of
+// the wheel away stay in their slot until their turn comes. Timers can't be
+// cancelled, owners that reschedule should ignore the stale expiries.
+template <typename T>
+class TimerWheel {
+public:
+    // The slot count is rounded up to a power of two
+    explicit TimerWheel(std::size_t slotNo = 1024) : m_tick(0), m_size(0) {
+        std::size_t n = 1;
+        while (n < slotNo) {
+            n <<= 1;
+        }
+        m_slots.resize(n);
+    }
+
+    // Fires the value delay ticks from now, at least one tick from now
+    void schedule(const std::uint64_t delay, T value) {
+        const std::uint64_t due = m_tick + (delay == 0 ? 1 : delay);
+        m_slots[due & (m_slots.size() - 1)].push_back({due, std::move(value)});
+        m_size++;
+    }
+
+    // Moves to the next tick and calls f with every value due on it, f may
+    // schedule more timers
+    template <typename F>
+    void advance(F&& f) {
+        m_tick++;
+        std::vector<Entry>& slot = m_slots[m_tick & (m_slots.size() - 1)];
+
+        // Swap the slot out so timers scheduled by f can't land in it while
+        // it's being walked
+        m_firing.swap(slot);
+        for (Entry& entry : m_firing) {
+            if (entry.due == m_tick) {
+                m_size--;
+                f(entry.value);
+            } else {
+                slot.push_back(std::move(entry));
+            }
+        }
+        m_firing.clear();
+    }
+
+    std::uint64_t getTick() const {
+        return m_tick;
+    }
+
+    // Timers still pending, stale ones included
+    std::size_t getSize() const {
+        return m_size;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t due;
+        T value;
+    };
+
+private:
+    std::vector<std::vector<Entry>> m_slots;
+    std::vector<Entry> m_firing; // Slot being advanced
+    std::uint64_t m_tick;
+    std::size_t m_size;
+};
+
+}
+
+#endif // !NC_GENERAL_TIMERWHEEL_HPP
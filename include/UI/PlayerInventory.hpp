@@ -17,6 +17,7 @@
 
 #include <UI/UI.hpp>
 #include <UI/ImageWidget.hpp>
+#include <Components/InventoryComponent.hpp>
 #include <entt/entt.hpp>
 
 namespace nc {
@@ -26,6 +27,12 @@ public:
     static constexpr unsigned int PLAYER_INV_ROWS = 5;
     static constexpr unsigned int PLAYER_INV_COLS = 9;
     static constexpr unsigned int PLAYER_INV_SIZE = PLAYER_INV_ROWS * PLAYER_INV_COLS;
+    // The hotbar is the last row
+    static constexpr unsigned int HOTBAR_SIZE  = PLAYER_INV_COLS;
+    static constexpr unsigned int HOTBAR_START = PLAYER_INV_SIZE - HOTBAR_SIZE;
+
+    static_assert(PLAYER_INV_SIZE <= InventoryComponent::CAPACITY,
+                  "Player inventory must fit in an inventory component");
 
 public:
     PlayerInventory();
@@ -17,6 +17,7 @@
 
 #include <UI/UI.hpp>
 #include <UI/ImageWidget.hpp>
+#include <UI/PlayerInventory.hpp>
 #include <Game/ItemStack.hpp>
 #include <entt/entt.hpp>
 
@@ -32,7 +33,7 @@ public:
 
 private:
     ImageWidget m_toolBar;
-    ImageWidget m_toolBarImages[9];
+    ImageWidget m_toolBarImages[PlayerInventory::HOTBAR_SIZE];
     ImageWidget m_selectedOverlay;
     unsigned int m_selectedPos;
     entt::const_handle m_player;
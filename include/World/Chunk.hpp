@@ -20,6 +20,7 @@
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <memory>
 
 namespace nc {
 
@@ -27,6 +28,7 @@ class Chunk : public sf::Drawable {
 public:
     static constexpr unsigned int CHUNK_SIZE = 32;
     static constexpr unsigned int VIEWABLE_TILES = 25;
+    static constexpr float TICK_COST_SMOOTHING   = 0.05f;
 
 public:
     Chunk(unsigned int xPos, unsigned int yPos);
@@ -36,6 +38,17 @@ public:
     Tile& getTile(sf::Vector2u pos);
     void setDirty();
     sf::Vector2u getPosition() const;
+    // Tiles with a random tick, chunks without any are never sampled
+    unsigned int getRandomTicked() const;
+    // Adds to the time spent ticking tiles this tick
+    void addTickTime(float seconds);
+    // Folds this tick's time into the tick cost and returns it, once per
+    // tick the chunk had time added in
+    float commitTickTime();
+    // Smoothed seconds spent ticking tiles, over the ticks it was ticked in
+    float getTickCost() const;
+    // Drawn over the tiles, in the chunk's pixel coordinates
+    void setOverlay(const sf::Drawable* overlay);
 
 protected:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
@@ -44,10 +57,14 @@ private:
     Tile m_tiles[CHUNK_SIZE][CHUNK_SIZE];
     unsigned int m_xPos;
     unsigned int m_yPos;
+    unsigned int m_randomTicked;
+    float m_tickTime; // Seconds spent ticking tiles this tick
+    float m_tickCost; // Moving average of m_tickTime
 
     mutable bool m_dirty;
-    mutable sf::RenderTexture m_tex; // Texture of the chunk
-    sf::Sprite m_sprite; // Sprite for the chunk
+    mutable std::unique_ptr<sf::RenderTexture> m_tex; // Created on first draw
+    mutable sf::Sprite m_sprite; // Sprite for the chunk
+    const sf::Drawable* m_overlay; // Fluids drawn over the tiles, or null
 };
 
 }
@@ -0,0 +1,142 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_WORLD_FLOWFIELDS_HPP
+#define NC_WORLD_FLOWFIELDS_HPP
+
+#include <World/Chunk.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace nc {
+
+class Map;
+
+// Flow fields toward shared goals over the tile collision grid. Every chunk
+// is a sector whose portals, the walkable runs across its edges, and the
+// distances between them are cached until one of its tiles changes. Goals
+// are searched over that portal graph, and the directions in a sector are
+// only built once something in it asks for one.
+class FlowFields {
+public:
+    using GoalId = std::uint32_t;
+
+    static constexpr unsigned int SIZE       = Chunk::CHUNK_SIZE;
+    static constexpr unsigned int TILES      = SIZE * SIZE;
+    static constexpr std::uint32_t NO_SECTOR = 0xffffffff;
+    static constexpr std::uint64_t NO_NODE   = ~std::uint64_t(0);
+    static constexpr std::uint32_t NO_COST   = 0xffffffff;
+
+public:
+    explicit FlowFields(Map& map);
+    // Fields toward the goal are rebuilt once it moves to another tile
+    void setGoal(GoalId goal, sf::Vector2u tile);
+    void removeGoal(GoalId goal);
+    // Step to take from the tile toward the goal, zero if there is no path
+    sf::Vector2i getDirection(GoalId goal, sf::Vector2u tile);
+    // Drops the portals of the tile's sector and, for edge tiles, the
+    // sector across the edge
+    void invalidateTile(unsigned int x, unsigned int y);
+    // Drops the portals of a sector and its neighbours, for new chunks
+    void invalidateSector(unsigned int x, unsigned int y);
+
+private:
+    // Also the direction codes of a field, after 0 for none
+    enum Side : std::uint8_t { Top, Bottom, Left, Right, SIDE_NO };
+
+    struct Portal {
+        std::uint16_t first; // Tile index of the run's first tile
+        std::uint16_t center; // Tile index the graph measures from
+        std::uint8_t length;
+        Side side;
+
+        bool operator==(const Portal& other) const {
+            return first == other.first && length == other.length &&
+                   side == other.side;
+        }
+    };
+
+    struct Sector {
+        std::bitset<TILES> blocked;
+        std::vector<Portal> portals; // By side, then along the edge
+        std::array<std::uint8_t, SIDE_NO + 1> sideStart; // First of each side
+        std::vector<std::uint16_t> distances; // Between each portal pair
+        std::uint32_t generation = 0; // Bumped on every rebuild
+        bool dirty               = true;
+    };
+
+    struct SectorField {
+        std::uint32_t generation; // Sector generation it was built from
+        bool stale; // Costs around the sector changed since the last check
+        std::vector<std::uint32_t> seeds; // Goal tile, then cost per portal
+        std::array<std::uint8_t, TILES> directions;
+    };
+
+    struct Goal {
+        sf::Vector2u tile;
+        bool searched              = false;
+        std::uint32_t graphVersion = 0; // m_graphVersion when searched
+        std::uint32_t sector       = NO_SECTOR; // Of the tile when searched
+        std::uint32_t generation   = 0; // Of that sector when searched
+        std::unordered_map<std::uint64_t, std::uint32_t> costs; // Per portal
+        std::unordered_map<std::uint32_t, SectorField> fields;
+    };
+
+private:
+    // NO_SECTOR outside the map
+    static std::uint32_t getSectorKey(unsigned int x, unsigned int y);
+    static std::uint64_t getNodeKey(std::uint32_t sector, std::size_t portal);
+
+    void markDirty(std::uint32_t key);
+    // Rebuilds the sectors marked dirty, so m_graphVersion is current
+    void rebuildDirty();
+    // Null if the chunk isn't generated, rebuilds the sector if dirty
+    Sector* getSector(std::uint32_t key);
+    // The matching portal of the sector across, NO_NODE if there is none
+    std::uint64_t getAcross(std::uint32_t key, const Sector& s,
+                            std::size_t portal);
+    void buildSector(std::uint32_t key, Sector& s);
+    void fillDistances(const Sector& s, std::uint16_t start);
+    // Marks the fields whose seeds may have changed for a second look
+    void search(Goal& g);
+    void searchPortals(Goal& g);
+    // Fields of the sector and its neighbours compare their seeds again
+    static void markStale(Goal& g, std::uint32_t key);
+    const SectorField* getField(Goal& g, std::uint32_t key);
+    void buildField(const Sector& s, const std::vector<std::uint32_t>& seeds,
+                    SectorField& f);
+
+private:
+    Map& m_map;
+    std::unordered_map<std::uint32_t, Sector> m_sectors;
+    std::unordered_map<GoalId, Goal> m_goals;
+    std::vector<std::uint32_t> m_dirty; // Sectors marked since a search
+    std::uint32_t m_graphVersion; // Bumped when portals or distances change
+    std::vector<std::uint32_t> m_costs; // Scratch integration field
+    std::vector<std::uint8_t> m_via; // Scratch, side a tile's cost came from
+    std::vector<std::uint16_t> m_queue; // Scratch breadth first queue
+    std::vector<std::uint32_t> m_seeds; // Scratch seeds of a field
+    std::vector<Portal> m_portals; // Scratch, portals before a rebuild
+    std::vector<std::uint16_t> m_distances; // Scratch, before a rebuild
+    // Scratch, the goal's costs before a search
+    std::unordered_map<std::uint64_t, std::uint32_t> m_previous;
+};
+
+}
+
+#endif // !NC_WORLD_FLOWFIELDS_HPP
@@ -0,0 +1,137 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_WORLD_FLUIDS_HPP
+#define NC_WORLD_FLUIDS_HPP
+
+#include <World/Chunk.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <bitset>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace nc {
+
+class Map;
+
+enum class Fluid : std::uint8_t { None, Water, Lava };
+
+// Water and lava spreading over the tile map as a cellular automaton. Only
+// cells next to a change last tick are updated, chunks without any sleep,
+// and the awake chunks are stepped in parallel against a halo of their
+// neighbours' border cells copied before the step.
+class Fluids {
+public:
+    static constexpr std::uint8_t MAX_LEVEL     = 8; // Level of a source
+    static constexpr std::uint8_t VISUAL_LEVELS = 4; // Levels drawn apart
+    // Levels lost per tile away from the source, by fluid
+    static constexpr std::uint8_t DECAY[] = {MAX_LEVEL, 1, 2};
+    // Fewer awake chunks are cheaper to step on the calling thread
+    static constexpr std::size_t PARALLEL_MIN_CHUNKS = 4;
+
+public:
+    explicit Fluids(Map& map);
+    Fluids(const Fluids&) = delete;
+    Fluids& operator=(const Fluids&) = delete;
+    // Places a source on a tile that isn't collidable
+    void placeSource(unsigned int x, unsigned int y, Fluid fluid);
+    // Clears the tile, fluid flowing into it comes back
+    void remove(unsigned int x, unsigned int y);
+    Fluid getFluid(unsigned int x, unsigned int y) const;
+    std::uint8_t getLevel(unsigned int x, unsigned int y) const;
+    // Call when the tile changed
+    void invalidateTile(unsigned int x, unsigned int y);
+    // Call when the chunk was generated, fluid next to it flows in
+    void invalidateChunk(unsigned int x, unsigned int y);
+    void setParallel(bool parallel);
+    bool isAsleep() const;
+    std::size_t getAwakeChunkNo() const;
+    void update();
+
+private:
+    static constexpr unsigned int SIZE   = Chunk::CHUNK_SIZE;
+    static constexpr unsigned int PADDED = SIZE + 2; // With the halo ring
+
+    struct Cell {
+        Fluid fluid         = Fluid::None;
+        std::uint8_t level  = 0;
+        bool source         = false;
+
+        bool operator==(const Cell& c) const {
+            return fluid == c.fluid && level == c.level && source == c.source;
+        }
+        bool operator!=(const Cell& c) const {
+            return !(*this == c);
+        }
+    };
+
+    struct Wake {
+        unsigned int x;
+        unsigned int y;
+        bool create; // Whether fluid may flow in, not just drain
+    };
+
+    // Fluid state of a chunk that fluid reached
+    struct FluidChunk {
+        unsigned int x;
+        unsigned int y;
+        Chunk* chunk;
+        FluidChunk* neighbours[4]; // Up, down, left, right, null if none
+        Cell cells[PADDED * PADDED]; // The outer ring mirrors the neighbours
+        std::bitset<SIZE * SIZE> solid; // Collidable tiles
+        std::vector<std::uint16_t> active; // Cells to update next step
+        std::bitset<SIZE * SIZE> queued; // Cells in active
+        std::vector<std::uint16_t> stepping; // Cells updated this step
+        std::vector<std::pair<std::uint16_t, Cell>> changes;
+        std::vector<Wake> outbox; // Tiles in other chunks to wake
+        std::unique_ptr<sf::VertexArray> overlay; // Quads drawn on the chunk
+        std::size_t updated; // Cells updated this step
+        bool awake;
+        bool visibleChange; // A drawn level changed this step
+    };
+
+private:
+    static std::uint32_t getKey(unsigned int x, unsigned int y);
+    static unsigned int getPadded(unsigned int index);
+    static std::uint8_t getVisualLevel(const Cell& cell);
+    // Redrawn only when the fluid or its visual level changes
+    static bool isDrawnDifferently(const Cell& a, const Cell& b);
+    FluidChunk* findChunk(unsigned int x, unsigned int y) const;
+    FluidChunk* getChunk(unsigned int x, unsigned int y);
+    const Cell* findCell(unsigned int x, unsigned int y) const;
+    void activate(unsigned int x, unsigned int y, bool create);
+    void activateAround(unsigned int x, unsigned int y, bool create);
+    void activate(FluidChunk& fc, unsigned int index);
+    void setCell(FluidChunk& fc, unsigned int index, const Cell& cell);
+    void exchangeHalo(FluidChunk& fc);
+    void step(FluidChunk& fc) const;
+    Cell computeCell(const FluidChunk& fc, unsigned int index) const;
+    void drawCell(FluidChunk& fc, unsigned int index) const;
+
+private:
+    Map& m_map;
+    bool m_render; // Builds the overlays, off when headless
+    bool m_parallel;
+    std::unordered_map<std::uint32_t, std::unique_ptr<FluidChunk>> m_chunks;
+    std::vector<FluidChunk*> m_awake;
+    std::vector<FluidChunk*> m_stepping; // Awake chunks this step
+    std::vector<std::future<void>> m_jobs;
+};
+
+}
+
+#endif // !NC_WORLD_FLUIDS_HPP
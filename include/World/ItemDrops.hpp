@@ -0,0 +1,73 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_WORLD_ITEMDROPS_HPP
+#define NC_WORLD_ITEMDROPS_HPP
+
+#include <Game/ItemStack.hpp>
+#include <General/TimerWheel.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nc {
+
+// Loose item stacks in the world. Nearby stacks of the same item are merged
+// every few ticks through a grid bucket pass so item-heavy areas stay at a
+// handful of entities, and despawns run off a timer wheel instead of a
+// countdown on every stack.
+class ItemDrops {
+public:
+    static constexpr std::uint64_t DESPAWN_TICKS = 5 * 60 * 60; // 5 minutes
+    static constexpr std::uint64_t PICKUP_DELAY  = 30; // Ticks after a drop
+    static constexpr unsigned int MERGE_INTERVAL = 20; // Ticks per merge pass
+    static constexpr float MERGE_RADIUS  = 1.0f; // Tiles, also the cell size
+    static constexpr float PICKUP_RADIUS = 1.0f; // Tiles from a player's feet
+    static constexpr float DRAW_SIZE     = 0.5f; // Tiles
+
+public:
+    ItemDrops();
+    entt::entity drop(entt::registry& reg, const ItemStack& stack,
+                      sf::Vector2f pos);
+    // Advances the despawn timers, merges and hands stacks to nearby players
+    void update(entt::registry& reg);
+    // Draws the stacks inside the area
+    void draw(entt::registry& reg, sf::RenderTarget& target,
+              const sf::FloatRect& area) const;
+
+private:
+    using Cell = std::pair<std::uint64_t, entt::entity>;
+
+private:
+    static std::uint64_t getCellKey(int x, int y);
+    void buildCells(entt::registry& reg);
+    // Calls f with every stack in the cells around the position
+    template <typename F>
+    void forEachNear(sf::Vector2f pos, F&& f) const;
+    void merge(entt::registry& reg);
+    void pickUp(entt::registry& reg);
+
+private:
+    TimerWheel<entt::entity> m_despawn;
+    std::vector<Cell> m_cells; // Stacks sorted by grid cell
+    std::vector<entt::entity> m_dead; // Stacks emptied this tick
+};
+
+}
+
+#endif // !NC_WORLD_ITEMDROPS_HPP
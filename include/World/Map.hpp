@@ -17,14 +17,26 @@
 
 #include <World/Chunk.hpp>
 #include <World/Generator.hpp>
+#include <World/SimulationLod.hpp>
+#include <World/FlowFields.hpp>
+#include <World/ItemDrops.hpp>
+#include <World/TileTicks.hpp>
+#include <World/Fluids.hpp>
+#include <General/Arena.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <entt/entt.hpp>
+#include <array>
+#include <utility>
+#include <vector>
 
 namespace nc {
 
 class Map {
 public:
-    static constexpr unsigned int CHUNK_NO = 1024;
+    static constexpr unsigned int CHUNK_NO  = 1024;
+    static constexpr unsigned int PAGE_SIZE = 32; // Chunks per page side
+    static constexpr unsigned int PAGE_NO   = CHUNK_NO / PAGE_SIZE;
+    static constexpr unsigned int ARENA_BLOCK_CHUNKS = 8;
 
 public:
     static sf::Vector2u getChunkPos(float x, float y);
@@ -46,7 +58,14 @@ public:
     Chunk* getChunk(sf::Vector2u pos);
     void generateChunk(unsigned int x, unsigned int y);
     void generateChunk(sf::Vector2u pos);
+    // Every generated chunk, in generation order
+    const std::vector<Chunk*>& getLoadedChunks() const;
     entt::registry& getRegistry();
+    SimulationLod& getLod();
+    FlowFields& getFlowFields();
+    ItemDrops& getItemDrops();
+    TileTicks& getTileTicks();
+    Fluids& getFluids();
     void simulateWorld(float dt);
     void placeTile(Tile* tile, unsigned int xPos, unsigned int yPos);
     void placeTile(Tile* tile, sf::Vector2u pos);
@@ -54,11 +73,29 @@ public:
     Tile* getTile(sf::Vector2u pos);
     void updateTile(unsigned int tileX, unsigned int tileY);
     void updateTile(sf::Vector2u pos);
+    // Redraws only the chunks showing the texture
+    void refreshTexture(const sf::Texture* texture);
+    // Replaces every placed copy of the tile with its current definition
+    void refreshTile(Tile* tile);
 
 private:
-    Chunk*** m_chunks;
+    using Page = std::array<Chunk*, PAGE_SIZE * PAGE_SIZE>;
+
+private:
+    void steerEntities();
+
+private:
+    Arena m_arena; // Chunks and pages, released with the map in one go
+    std::array<Page*, PAGE_NO * PAGE_NO> m_pages; // Created on first use
+    std::vector<Chunk*> m_loaded; // Every generated chunk
     entt::registry m_reg;
     Generator* m_gen;
+    SimulationLod m_lod; // Step of every entity in m_reg
+    FlowFields m_flow; // Paths toward every player
+    ItemDrops m_items; // Loose item stacks
+    TileTicks m_ticks; // Random and scheduled tile ticks
+    Fluids m_fluids; // Water and lava over the tiles
+    std::vector<std::pair<entt::entity, sf::Vector2f>> m_players; // Scratch
 };
 
 }
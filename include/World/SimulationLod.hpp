@@ -0,0 +1,56 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_WORLD_SIMULATIONLOD_HPP
+#define NC_WORLD_SIMULATIONLOD_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace nc {
+
+// Buckets entities into tiers by their distance to the nearest player. The
+// near tier is stepped every tick and farther tiers every few ticks with all
+// the time they missed, staggered by entity so each tick steps an even share.
+class SimulationLod {
+public:
+    static constexpr unsigned int TIER_NO = 3;
+    // Tiles from the nearest player, the last tier is unbounded
+    static constexpr float TIER_DISTANCE[TIER_NO - 1] = {48.0f, 128.0f};
+    static constexpr unsigned int TIER_INTERVAL[TIER_NO] = {1, 4, 16};
+    static constexpr unsigned int REFRESH_INTERVAL = 8; // Ticks per retiering
+    static constexpr float VIEW_MARGIN = 2.0f; // Tiles past the view edges
+
+public:
+    SimulationLod();
+    // Sets the step of every entity for this tick, call before the systems
+    // reading it
+    void update(entt::registry& reg, float dt);
+
+private:
+    void assignTiers(entt::registry& reg);
+
+private:
+    double m_time; // Simulated seconds
+    std::uint64_t m_tick;
+    std::vector<entt::entity> m_new; // Entities without a LodComponent yet
+    std::vector<sf::Vector2f> m_players; // Player positions while retiering
+    std::vector<sf::FloatRect> m_views; // Player views while retiering
+};
+
+}
+
+#endif // !NC_WORLD_SIMULATIONLOD_HPP
@@ -21,6 +21,7 @@
 namespace nc {
 
 class Map;
+struct TileBehaviour;
 
 class Tile : public sf::Sprite {
 public:
@@ -36,12 +37,16 @@ public:
     bool isCollidable() const;
     void setCollisionBox(const sf::FloatRect& collisionBox);
     const sf::FloatRect& getCollisionBox();
+    void setBehaviour(const TileBehaviour* behaviour);
+    const TileBehaviour* getBehaviour() const;
+    bool hasRandomTick() const;
 
 private:
     unsigned int m_size;
     std::string m_name;
     bool m_hasCollision;
     sf::FloatRect m_collisionBox;
+    const TileBehaviour* m_behaviour; // Owned by the GameRegistry, or null
     static sf::IntRect m_textureRects[16];
 };
 
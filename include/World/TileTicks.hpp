@@ -0,0 +1,62 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NC_WORLD_TILETICKS_HPP
+#define NC_WORLD_TILETICKS_HPP
+
+#include <General/TimerWheel.hpp>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace nc {
+
+class Map;
+class Chunk;
+
+// Runs tile behaviours over time without scanning every loaded tile. Each
+// tick samples a few random tiles of every chunk holding random-ticked
+// tiles, and runs the scheduled ticks that came due off a timer wheel.
+class TileTicks {
+public:
+    static constexpr unsigned int RANDOM_TICKS = 3; // Tiles per chunk per tick
+    static constexpr std::size_t WHEEL_SLOTS   = 256;
+
+public:
+    explicit TileTicks(Map& map);
+    // Random ticks of the same seed hit the same tiles
+    void setSeed(std::uint32_t seed);
+    // Runs the tile's scheduled tick delay ticks from now. A tile already
+    // scheduled keeps whichever tick comes first.
+    void schedule(unsigned int x, unsigned int y, std::uint64_t delay);
+    void update();
+
+private:
+    static std::uint64_t getKey(unsigned int x, unsigned int y);
+    void randomTick(Chunk* chunk);
+    void scheduledTick(std::uint64_t key);
+    void addTickTime(Chunk* chunk, float seconds);
+
+private:
+    Map& m_map;
+    std::mt19937 m_rng; // Raw output only, for the same ticks on every platform
+    TimerWheel<std::uint64_t> m_wheel; // Tile keys
+    std::unordered_map<std::uint64_t, std::uint64_t> m_pending; // Due ticks
+    std::vector<Chunk*> m_ticked; // Given tick time this tick, may repeat
+};
+
+}
+
+#endif // !NC_WORLD_TILETICKS_HPP
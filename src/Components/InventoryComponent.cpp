@@ -13,14 +13,158 @@
 // limitations under the License.
 
 #include <Components/InventoryComponent.hpp>
+#include <algorithm>
 
 namespace nc {
 
-InventoryComponent::InventoryComponent(unsigned int size)
-    : inventory(new ItemStack[size]), size(size) {}
+InventoryComponent::InventoryComponent(const unsigned int size)
+    : m_slots(), m_size(std::min(size, CAPACITY)) {}
 
-InventoryComponent::~InventoryComponent() {
-    delete[] inventory;
+unsigned int InventoryComponent::getSize() const {
+    return m_size;
 }
 
-}
\ No newline at end of file
+ItemStack& InventoryComponent::getSlot(const unsigned int slot) {
+    return m_slots[slot];
+}
+
+const ItemStack& InventoryComponent::getSlot(const unsigned int slot) const {
+    return m_slots[slot];
+}
+
+unsigned int InventoryComponent::getCount(const Item* item) const {
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < m_size; i++) {
+        if (m_slots[i].getItem() == item) {
+            count += m_slots[i].getCount();
+        }
+    }
+
+    return count;
+}
+
+unsigned int InventoryComponent::getSpace(const Item* item) const {
+    unsigned int space = 0;
+    for (unsigned int i = 0; i < m_size; i++) {
+        if (m_slots[i].isEmpty()) {
+            space += ItemStack::MAX_COUNT;
+        } else if (m_slots[i].getItem() == item) {
+            space += ItemStack::MAX_COUNT - m_slots[i].getCount();
+        }
+    }
+
+    return space;
+}
+
+unsigned int InventoryComponent::insert(Item* item, unsigned int count) {
+    if (item == nullptr) {
+        return 0;
+    }
+
+    const unsigned int requested = count;
+    for (unsigned int i = 0; i < m_size && count > 0; i++) {
+        ItemStack& s = m_slots[i];
+        if (s.getItem() == item) {
+            const unsigned int added =
+                std::min(count, ItemStack::MAX_COUNT - s.getCount());
+            s.setCount(s.getCount() + added);
+            count -= added;
+        }
+    }
+
+    for (unsigned int i = 0; i < m_size && count > 0; i++) {
+        ItemStack& s = m_slots[i];
+        if (s.isEmpty()) {
+            const unsigned int added = std::min(count, ItemStack::MAX_COUNT);
+            s.setItem(item, added);
+            count -= added;
+        }
+    }
+
+    return requested - count;
+}
+
+bool InventoryComponent::insertAll(Item* item, const unsigned int count) {
+    if (item == nullptr || getSpace(item) < count) {
+        return false;
+    }
+
+    insert(item, count);
+    return true;
+}
+
+unsigned int InventoryComponent::remove(const Item* item, unsigned int count) {
+    if (item == nullptr) {
+        return 0;
+    }
+
+    const unsigned int requested = count;
+    for (unsigned int i = m_size; i-- > 0 && count > 0;) {
+        ItemStack& s = m_slots[i];
+        if (s.getItem() == item) {
+            const unsigned int removed = std::min(count, s.getCount());
+            s.setCount(s.getCount() - removed);
+            count -= removed;
+        }
+    }
+
+    return requested - count;
+}
+
+bool InventoryComponent::removeAll(const Item* item,
+                                   const unsigned int count) {
+    if (item == nullptr || getCount(item) < count) {
+        return false;
+    }
+
+    remove(item, count);
+    return true;
+}
+
+bool InventoryComponent::split(const unsigned int from, const unsigned int to,
+                               const unsigned int count) {
+    if (from >= m_size || to >= m_size || from == to || count == 0) {
+        return false;
+    }
+
+    ItemStack& src = m_slots[from];
+    ItemStack& dst = m_slots[to];
+    if (src.getCount() < count ||
+        (!dst.isEmpty() && dst.getItem() != src.getItem()) ||
+        dst.getCount() + count > ItemStack::MAX_COUNT) {
+        return false;
+    }
+
+    dst.setItem(src.getItem(), dst.getCount() + count);
+    src.setCount(src.getCount() - count);
+    return true;
+}
+
+unsigned int InventoryComponent::moveTo(const unsigned int slot,
+                                        InventoryComponent& to,
+                                        const unsigned int count) {
+    // Merging into the same inventory could land on the source slot
+    if (slot >= m_size || &to == this) {
+        return 0;
+    }
+
+    ItemStack& s = m_slots[slot];
+    const unsigned int moved =
+        to.insert(s.getItem(), std::min(count, s.getCount()));
+    s.setCount(s.getCount() - moved);
+    return moved;
+}
+
+unsigned int InventoryComponent::transferTo(InventoryComponent& to,
+                                            const unsigned int max) {
+    unsigned int moved = 0;
+    for (unsigned int i = 0; i < m_size && moved < max; i++) {
+        if (!m_slots[i].isEmpty()) {
+            moved += moveTo(i, to, max - moved);
+        }
+    }
+
+    return moved;
+}
+
+}
@@ -0,0 +1,57 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/AnimationLibrary.hpp>
+#include <spdlog/spdlog.h>
+
+namespace nc {
+
+ClipId AnimationLibrary::add(const std::string& name,
+                             const AnimationClip& clip) {
+    const auto it = m_ids.find(name);
+    if (it != m_ids.end()) {
+        m_clips[it->second] = clip;
+        return it->second;
+    }
+
+    if (m_clips.size() >= NO_CLIP) {
+        spdlog::error("Too many animation clips, ignoring {}", name);
+        return NO_CLIP;
+    }
+
+    const auto id = static_cast<ClipId>(m_clips.size());
+    m_clips.push_back(clip);
+    m_ids.emplace(name, id);
+    return id;
+}
+
+ClipId AnimationLibrary::getId(const std::string& name) const {
+    const auto it = m_ids.find(name);
+    if (it == m_ids.end()) {
+        spdlog::warn("Could not find animation clip {}!", name);
+        return NO_CLIP;
+    }
+
+    return it->second;
+}
+
+const AnimationClip& AnimationLibrary::get(const ClipId id) const {
+    return m_clips[id];
+}
+
+std::size_t AnimationLibrary::getClipNo() const {
+    return m_clips.size();
+}
+
+}
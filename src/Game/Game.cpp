@@ -15,150 +15,146 @@
 #include <Game/Game.hpp>
 #include <Game/Item.hpp>
 #include <General/Version.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <General/Hash.hpp>
+#include <General/AssetLoader.hpp>
+#include <General/AssetWatcher.hpp>
+#include <Game/LoadingState.hpp>
 #include <Game/MainMenuState.hpp>
+#include <Game/PlayingState.hpp>
+#include <Components/VelocityComponent.hpp>
 #include <World/Chunk.hpp>
+#include <World/Map.hpp>
+#include <World/OverworldGenerator.hpp>
 #include <imgui.h>
 #include <imgui-SFML.h>
 #include <physfs.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <cassert>
+#include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
 
-namespace {
-
-PHYSFS_EnumerateCallbackResult populateJson(const std::string& path,
-                                            nlohmann::json& json) {
-    PHYSFS_File* fileHandle = PHYSFS_openRead(path.c_str());
-    PHYSFS_sint64 fileSize;
-    PHYSFS_sint64 read;
-    char* fileData = nullptr;
-
-    if (fileHandle == NULL) {
-        spdlog::warn("Could not open file {}!", path);
-        return PHYSFS_ENUM_ERROR;
-    } else {
-        fileSize = PHYSFS_fileLength(fileHandle);
-        if (fileSize == -1) {
-            spdlog::warn("Could not retreive size for file {}!", path);
-            return PHYSFS_ENUM_ERROR;
-        }
-        fileData = new char[fileSize];
-        read     = PHYSFS_readBytes(fileHandle, fileData, fileSize);
-        if (read < fileSize) {
-            spdlog::warn("Could not read file {}!", path);
-            delete[] fileData;
-            return PHYSFS_ENUM_ERROR;
-        }
-        PHYSFS_close(fileHandle);
-    }
-
-    json = nlohmann::json::parse(fileData, fileData + fileSize);
-    delete[] fileData;
+namespace nc {
 
-    return PHYSFS_ENUM_OK;
-}
+Game* Game::m_inst = nullptr;
 
-PHYSFS_EnumerateCallbackResult
-    loadTextureCallback(void* data, const char* origdir, const char* fname) {
-    std::string texPath;
-    texPath += origdir;
-    texPath += '/';
-    texPath += fname;
+Game::Game(int argc, char** argv)
+    : m_startupDone(false), m_argc(argc), m_argv(argv), m_drawConsole(false),
+      m_timeScale(1.0f),
+      m_gameState(nullptr), m_requestedState(nullptr), m_nextListener(0),
+      m_sfmlErr("SFML: "), m_catchingUp(false), m_tickDeferred(false),
+      m_droppedTicks(0), m_deferredTicks(0) {
+    assert(m_inst == nullptr);
+    m_inst = this;
 
-    if (!nc::Game::getInstance()->getTextureAtlas().addTexture(texPath)) {
-        spdlog::error("Could not load texture {}", texPath);
+    // Formatting and file IO happen on a background thread, when the queue
+    // is full the oldest messages are dropped instead of stalling the frame
+    spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+
+    m_console = std::make_shared<LogConsole>();
+    m_sinks   = std::make_shared<spdlog::sinks::dup_filter_sink_mt>(
+        std::chrono::seconds(5));
+    m_sinks->add_sink(m_console);
+    std::string fileError;
+    try {
+        m_sinks->add_sink(
+            std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                "logs/nanocraft.log", LOG_FILE_SIZE, LOG_FILE_NO));
+    } catch (const spdlog::spdlog_ex& e) {
+        fileError = e.what();
     }
 
-    return PHYSFS_ENUM_OK;
-}
-
-PHYSFS_EnumerateCallbackResult loadItemCallback(void* data, const char* origdir,
-                                                const char* fname) {
-    std::string path;
-    path += origdir;
-    path += '/';
-    path += fname;
-
-    nlohmann::json j;
+    m_logger = std::make_shared<spdlog::async_logger>(
+        "nanolog", m_sinks, spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest);
+    m_logger->set_level(spdlog::level::trace);
+    m_logger->flush_on(spdlog::level::err);
+    spdlog::set_default_logger(m_logger);
+    spdlog::flush_every(std::chrono::seconds(1));
 
-    if (populateJson(path, j) != PHYSFS_ENUM_OK) {
-        return PHYSFS_ENUM_OK;
+    if (!fileError.empty()) {
+        spdlog::warn("Could not open log file: {}", fileError);
     }
 
-    nc::Item* i = new nc::Item;
-    i->setName(j["name"].get<std::string>());
-    i->setTexture(j["texture"].get<std::string>());
-    if (j.contains("placeTile")) {
-        i->setPlaceableTile(j["placeTile"].get<std::string>());
-    }
+    NC_PROFILE_THREAD("Main");
+    m_startup.mark("logging");
+}
 
-    nc::Game::getInstance()->getRegistry().registerItem(i);
+Game::~Game() {
+    // Workers may still log, finish them before the logger goes away
+    m_pool.shutdown();
 
-    return PHYSFS_ENUM_OK;
+    // Drain the log queue while everything it references is still alive
+    sf::err().rdbuf(nullptr);
+    spdlog::shutdown();
 }
 
-PHYSFS_EnumerateCallbackResult loadTileCallback(void* data, const char* origdir,
-                                                const char* fname) {
-    std::string path;
-    path += origdir;
-    path += '/';
-    path += fname;
-
-    nlohmann::json j;
+int Game::run() {
+    setup();
 
-    if (populateJson(path, j) != PHYSFS_ENUM_OK) {
-        return PHYSFS_ENUM_OK;
+    if (!m_options.recordPath.empty() && m_options.replayPath.empty()) {
+        m_recorder.open(m_options.recordPath, m_settings);
     }
 
-    nc::Tile* t = new nc::Tile;
-    t->setName(j["name"].get<std::string>());
-    t->setTexture(j["texture"].get<std::string>());
-    if (j.contains("collidable")) {
-        t->setCollidable(j["collidable"].get<bool>());
+    bool success = true;
+    if (!m_options.replayPath.empty()) {
+        success = executeReplay();
+    } else if (m_options.fluidBench) {
+        success = executeFluidBench();
+    } else if (m_options.headless) {
+        executeHeadless();
+    } else {
+        execute();
     }
 
-    nc::Game::getInstance()->getRegistry().registerTile(t);
-
-    return PHYSFS_ENUM_OK;
+    m_recorder.close();
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
+const Settings& Game::getSettings() const {
+    return m_settings;
 }
 
-namespace nc {
-
-Game* Game::m_inst = nullptr;
-
-Game::Game(int argc, char** argv)
-    : m_argc(argc), m_argv(argv), m_drawConsole(false), m_timeScale(1.0f),
-      m_gameState(nullptr), m_requestedState(nullptr) {
-    assert(m_inst == nullptr);
-    m_inst = this;
+void Game::setSettings(const Settings& settings) {
+    m_settings = settings;
+    applySettings(m_settings);
 
-    m_sink   = std::make_shared<spdlog::sinks::ostream_sink_mt>(m_logData);
-    m_logger = std::make_shared<spdlog::logger>("nanolog", m_sink);
-    m_logger->set_level(spdlog::level::trace);
-    spdlog::set_default_logger(m_logger);
+    for (const auto& l : m_listeners) {
+        l.second(m_settings);
+    }
 }
 
-void Game::run() {
-    setup();
-    execute();
+unsigned int Game::addSettingsListener(SettingsListener listener) {
+    m_listeners.emplace_back(m_nextListener, std::move(listener));
+    return m_nextListener++;
 }
 
-const nlohmann::json& Game::getSettings() const {
-    return m_settings;
+void Game::removeSettingsListener(const unsigned int id) {
+    m_listeners.erase(
+        std::remove_if(m_listeners.begin(), m_listeners.end(),
+                       [id](const auto& l) { return l.first == id; }),
+        m_listeners.end());
 }
 
 void Game::saveSettings() {
     std::ofstream o("settings.json");
-    o << std::setw(4) << m_settings << std::endl;
+    o << std::setw(4) << m_settings.toJson() << std::endl;
 
     o.close();
 }
 
+const ActionMap& Game::getActionMap() const {
+    return m_actions;
+}
+
 TextureAtlas& Game::getTextureAtlas() {
     return m_atlas;
 }
@@ -188,13 +184,71 @@ GameState* Game::getState() const {
 }
 
 sf::RenderWindow& Game::getWindow() {
-    return m_win;
+    return *m_win;
 }
 
 GameRegistry& Game::getRegistry() {
     return m_reg;
 }
 
+AnimationLibrary& Game::getAnimations() {
+    return m_animations;
+}
+
+ThreadPool& Game::getThreadPool() {
+    return m_pool;
+}
+
+const LaunchOptions& Game::getLaunchOptions() const {
+    return m_options;
+}
+
+std::string Game::getAssetCacheDir() const {
+    return m_options.noCache ? std::string() : ASSET_CACHE_DIR;
+}
+
+bool Game::isHeadless() const {
+    return m_options.headless;
+}
+
+bool Game::isDeterministic() const {
+    return m_recorder.isOpen() || !m_options.replayPath.empty();
+}
+
+bool Game::isTickOverBudget() const {
+    // Shedding work depends on wall time, which a replay can't reproduce
+    if (isDeterministic()) {
+        return false;
+    }
+
+    if (m_tickClock.getElapsedTime().asSeconds() >= TICK_BUDGET) {
+        return true;
+    }
+
+    // Ticks run to catch up after a stall must not spend more than a whole
+    // timestep of real time, or the backlog never shrinks
+    return m_catchingUp &&
+           m_catchupClock.getElapsedTime().asSeconds() >= TIMESTEP;
+}
+
+void Game::deferWork() {
+    m_tickDeferred = true;
+}
+
+unsigned long Game::getDroppedTicks() const {
+    return m_droppedTicks;
+}
+
+unsigned long Game::getDeferredTicks() const {
+    return m_deferredTicks;
+}
+
+void Game::markStartupPhase(const std::string& name) {
+    if (!m_startupDone) {
+        m_startup.mark(name);
+    }
+}
+
 Game* Game::getInstance() {
     return m_inst;
 }
@@ -203,8 +257,16 @@ void Game::setup() {
     if (!PHYSFS_init(m_argv[0])) {
         throw std::runtime_error("Failed to initialize PHYSFS!");
     }
+    m_startup.mark("physfs_init");
+
+    sf::err().rdbuf(&m_sfmlErr);
 
-    sf::err().rdbuf(m_logData.rdbuf());
+    m_options = LaunchOptions::parse(m_argc, m_argv);
+    if (m_options.headless) {
+        // There is no console to read the log from
+        m_sinks->add_sink(
+            std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+    }
 
     spdlog::info("Nanocraft v{}.{}.{}.{}", NC_VER_MAJOR, NC_VER_MINOR,
                  NC_VER_PATCH, NC_VER_TWEAK);
@@ -216,15 +278,17 @@ void Game::setup() {
     }
 
 #ifndef NC_DEBUG
-    if (!std::filesystem::exists("data/base.zip") ||
-        !std::filesystem::is_regular_file("data/base.zip")) {
+    const bool hasPack = !m_options.noPack &&
+                         std::filesystem::is_regular_file(ASSET_PACK_PATH);
+    if (std::filesystem::is_regular_file("data/base.zip")) {
+        if (!PHYSFS_mount("data/base.zip", "/", 0)) {
+            throw std::runtime_error(
+                "Could not load base game data file! (data/base.zip)");
+        }
+    } else if (!hasPack) {
         throw std::runtime_error(
             "No base game data file found! (data/base.zip)");
     }
-    if (!PHYSFS_mount("data/base.zip", "/", 0)) {
-        throw std::runtime_error(
-            "Could not load base game data file! (data/base.zip)");
-    }
 #else
     if (!std::filesystem::exists("data/base") ||
         !std::filesystem::is_directory("data/base")) {
@@ -234,23 +298,31 @@ void Game::setup() {
         throw std::runtime_error("Could not load base game directory!");
     }
 #endif
+    m_startup.mark("mount");
 
     // Get settings from file if available
     if (std::filesystem::exists("settings.json")) {
         loadSettings();
     } else {
-        createDefaultSettings();
         saveSettings();
     }
+    m_actions = ActionMap(m_settings.controls);
+    m_startup.mark("settings");
+
+    if (m_options.headless) {
+        return;
+    }
+
+    m_atlas.createDefaultTexture();
 
     // Create window
-    auto modeWidth  = m_settings["display"]["resolution_x"].get<unsigned int>();
-    auto modeHeight = m_settings["display"]["resolution_y"].get<unsigned int>();
+    const unsigned int modeWidth  = m_settings.display.resolutionX;
+    const unsigned int modeHeight = m_settings.display.resolutionY;
     sf::Uint32 windowStyle =
         sf::Style::Titlebar | sf::Style::Close; // Default window style
-    if (m_settings["display"]["window_type"] == "fullscreen") {
+    if (m_settings.display.windowType == WindowType::Fullscreen) {
         windowStyle |= sf::Style::Fullscreen;
-    } else if (m_settings["display"]["window_type"] == "borderless") {
+    } else if (m_settings.display.windowType == WindowType::Borderless) {
         windowStyle = sf::Style::None;
     }
 
@@ -261,89 +333,190 @@ void Game::setup() {
         0.0f, 0.0f, static_cast<float>(Chunk::VIEWABLE_TILES),
         static_cast<float>(Chunk::VIEWABLE_TILES) / (aspectRatio)));
 
-    m_win.create(sf::VideoMode(modeWidth, modeHeight), "Nanocraft",
-                 windowStyle);
-    m_win.setView(m_view);
+    m_win = std::make_unique<sf::RenderWindow>(
+        sf::VideoMode(modeWidth, modeHeight), "Nanocraft", windowStyle);
+    m_win->setView(m_view);
+    m_win->setVerticalSyncEnabled(m_settings.display.vsync);
+    m_startup.mark("window");
 
-    ImGui::SFML::Init(m_win);
+    ImGui::SFML::Init(*m_win);
     ImGui::GetIO().IniFilename = nullptr;
+    m_startup.mark("imgui");
 }
 
 void Game::execute() {
-    loadTextures();
-    loadItems();
-    loadTiles();
+    if (loadAssetPack()) {
+        m_startup.mark("assets");
+        setState(new MainMenuState());
+        m_startup.mark("main_menu");
+    } else {
+        // Decode assets behind a loading screen, which opens the main menu
+        // and marks the end of the asset phase
+        setState(new LoadingState());
+    }
 
-    // Get into the main menu
-    setState(new MainMenuState());
+    Histogram& frameTimes = Metrics::getHistogram("game.frame_time");
+    Counter& drawCalls    = Metrics::getCounter("render.draw_calls");
+    Gauge& frameDrawCalls = Metrics::getGauge("render.draw_calls_per_frame");
+    Metrics::setDumpInterval(m_settings.debug.metricsDumpInterval,
+                             m_settings.debug.metricsDumpPath);
+
+#ifdef NC_DEBUG
+    // Loose files are mounted, so edits can be picked up while running
+    AssetWatcher watcher("data/base");
+#endif
 
     sf::Clock frameTime;
     sf::Clock updateFpsTimer;
-    float fps   = 0.0f;
-    float accum = 0.0f;
+    float fps       = 0.0f;
+    float accum     = 0.0f;
+    bool firstFrame = true;
+
+    while (m_win->isOpen()) {
+        NC_PROFILE_FRAME();
 
-    while (m_win.isOpen()) {
         // Get delta time
         float elapsed = m_delta.restart().asSeconds();
         accum += elapsed;
+        frameTimes.record(elapsed);
 
-        if (m_requestedState != nullptr) {
-            delete m_gameState;
-            m_gameState      = m_requestedState;
-            m_requestedState = nullptr;
+        switchState();
+
+#ifdef NC_DEBUG
+        for (const std::string& path : watcher.poll()) {
+            sf::Clock reloadTime;
+            if (AssetLoader::reload(path)) {
+                spdlog::info("Reloaded {} in {:.2f} ms", path,
+                             reloadTime.getElapsedTime().asSeconds() *
+                                 1000.0f);
+            }
         }
+#endif
 
-        m_gameState->perFrame();
+        {
+            NC_PROFILE_SCOPE("GameState::perFrame");
+            m_gameState->perFrame();
+        }
 
         // Process events
-        sf::Event e;
-        while (m_win.pollEvent(e)) {
-            // Process imgui events
-            ImGui::SFML::ProcessEvent(e);
-
-            if (e.type == sf::Event::Closed) {
-                m_win.close();
-            } else if (e.type == sf::Event::KeyPressed) {
-                if (e.key.code == m_settings["controls"]["toggle_console"]
-                                      .get<sf::Keyboard::Key>()) {
-                    // Draw console with tilde
-                    m_drawConsole = !m_drawConsole;
+        {
+            NC_PROFILE_SCOPE("Events");
+            sf::Event e;
+            while (m_win->pollEvent(e)) {
+                // Process imgui events
+                ImGui::SFML::ProcessEvent(e);
+
+                if (e.type == sf::Event::Closed) {
+                    m_win->close();
+                } else if (e.type == sf::Event::KeyPressed) {
+                    if (m_actions.getAction(e.key.code) ==
+                        Action::ToggleConsole) {
+                        // Draw console with tilde
+                        m_drawConsole = !m_drawConsole;
+                    }
                 }
-            }
 
-            m_gameState->handleEvent(e);
+                m_gameState->handleEvent(e);
+            }
         }
 
         // Update imgui
-        ImGui::SFML::Update(m_win, sf::seconds(elapsed));
+        ImGui::SFML::Update(*m_win, sf::seconds(elapsed));
 
         // Update state
-        while (accum >= TIMESTEP) {
-            m_gameState->update(TIMESTEP * m_timeScale);
+        {
+            NC_PROFILE_SCOPE("Update");
+            unsigned int ticks = 0;
+            m_catchingUp       = false;
+            m_catchupClock.restart();
+            while (accum >= TIMESTEP) {
+                if (ticks >= MAX_CATCHUP_TICKS) {
+                    // Drop the backlog instead of spiralling after a stall
+                    const auto dropped =
+                        static_cast<unsigned int>(accum / TIMESTEP);
+                    m_droppedTicks += dropped;
+                    accum -= static_cast<float>(dropped) * TIMESTEP;
+                    break;
+                }
+
+                NC_PROFILE_SCOPE("Tick");
+                tick(TIMESTEP * m_timeScale);
 
-            accum -= TIMESTEP;
+                m_catchingUp = true;
+                accum -= TIMESTEP;
+                ticks++;
+            }
         }
 
         // Draw gui here
         if (m_drawConsole) {
-            ImGui::Begin("Console");
-            std::string s = m_logData.str();
-            ImGui::TextUnformatted(s.c_str());
-            ImGui::End();
+            NC_PROFILE_SCOPE("Debug UI");
+            m_console->draw();
             // Draw performance window
             ImGui::Begin("Performance");
             ImGui::Text("FPS: %.2f", fps);
+            ImGui::Text("Frame cap: %.0f", m_pacer.getTargetFramerate());
+            ImGui::Text("Frame time: %.2f ms",
+                        m_pacer.getFrameTime() * 1000.0f);
+            ImGui::Text("Jitter: %.3f ms (max %.3f ms)",
+                        m_pacer.getJitter() * 1000.0f,
+                        m_pacer.getMaxJitter() * 1000.0f);
+            ImGui::Text("Dropped ticks: %lu", m_droppedTicks);
+            ImGui::Text("Deferred ticks: %lu", m_deferredTicks);
             ImGui::End();
+            Metrics::drawWindow();
+#ifdef NC_PROFILE
+            Profiler::drawWindow();
+#endif
         }
 
         // Draw
-        m_win.setView(m_view);
-        m_win.clear();
-        m_gameState->draw(m_win);
-        // Draw imgui
-        ImGui::EndFrame();
-        ImGui::SFML::Render(m_win);
-        m_win.display();
+        {
+            NC_PROFILE_SCOPE("Draw");
+            const std::uint64_t callsBefore = drawCalls.get();
+            m_win->setView(m_view);
+            m_win->clear();
+            m_gameState->draw(*m_win);
+            // Draw imgui
+            ImGui::EndFrame();
+            ImGui::SFML::Render(*m_win);
+            frameDrawCalls.set(
+                static_cast<std::int64_t>(drawCalls.get() - callsBefore));
+        }
+
+        {
+            NC_PROFILE_SCOPE("Display");
+            m_win->display();
+        }
+
+        if (!m_startupDone) {
+            // Behind a loading screen the menu is drawn in a later frame
+            const bool menu =
+                dynamic_cast<MainMenuState*>(m_gameState) != nullptr;
+            if (firstFrame || menu) {
+                m_startup.mark(firstFrame ? "first_frame" : "menu_frame");
+                firstFrame = false;
+            }
+            if (menu) {
+                finishStartup();
+            }
+        }
+
+        // Menus and unfocused windows don't need the full frame rate
+        if (!m_win->hasFocus() || m_gameState->isIdle()) {
+            m_pacer.setTargetFramerate(
+                static_cast<float>(m_settings.display.idleFps));
+        } else {
+            m_pacer.setTargetFramerate(
+                static_cast<float>(m_settings.display.fpsCap));
+        }
+
+        {
+            NC_PROFILE_SCOPE("Frame pacing");
+            m_pacer.wait();
+        }
+
+        Metrics::update();
 
         if (updateFpsTimer.getElapsedTime().asSeconds() >= 2.0f) {
             fps = 1.0f / frameTime.restart().asSeconds();
@@ -354,41 +527,322 @@ void Game::execute() {
     }
 }
 
-void Game::loadSettings() {
-    m_settings.clear();
+void Game::finishStartup() {
+    m_startupDone = true;
+    m_startup.log("Startup");
+    Metrics::getGauge("game.startup_time_ms")
+        .set(static_cast<std::int64_t>(m_startup.getElapsed() * 1000.0f));
+
+    if (m_options.startupBench) {
+        nlohmann::json j = m_startup.toJson();
+        j["version"] = fmt::format("{}.{}.{}.{}", NC_VER_MAJOR, NC_VER_MINOR,
+                                   NC_VER_PATCH, NC_VER_TWEAK);
+#ifdef NC_DEBUG
+        j["build"] = "debug";
+#else
+        j["build"] = "release";
+#endif
+        j["asset_cache"] = !m_options.noCache;
+        std::cout << j.dump(4) << std::endl;
+        m_win->close();
+    }
+}
+
+void Game::executeHeadless() {
+    loadAssets();
+
+    auto* state = new PlayingState();
+    setState(state);
+
+    const bool throttled = m_options.tickRate > 0.0f;
+    const float dt       = throttled ? 1.0f / m_options.tickRate : TIMESTEP;
+    Histogram& tickTimes = Metrics::getHistogram("game.tick_time");
+    Metrics::setDumpInterval(m_settings.debug.metricsDumpInterval,
+                             m_settings.debug.metricsDumpPath);
+
+    if (m_recorder.isOpen() && m_options.walkSpeed > 0.0f) {
+        spdlog::warn("Headless walking is not part of the recorded input!");
+    }
+
+    spdlog::info("Running headless at {} ticks per second for {} seconds",
+                 throttled ? std::to_string(m_options.tickRate) : "unlimited",
+                 m_options.duration > 0.0f
+                     ? std::to_string(m_options.duration)
+                     : "unlimited");
+
+    m_pacer.setTargetFramerate(m_options.tickRate);
+    sf::Clock wallClock;
+    unsigned long ticks = 0;
+    float simulated     = 0.0f;
+
+    while (m_options.duration <= 0.0f || simulated < m_options.duration) {
+        switchState();
+
+        // Walk in a wide circle so new chunks keep streaming in
+        if (m_options.walkSpeed > 0.0f && m_gameState == state) {
+            const float heading = simulated * 0.05f;
+            state->getPlayer().get<VelocityComponent>().velocity =
+                sf::Vector2f(std::cos(heading), std::sin(heading)) *
+                m_options.walkSpeed;
+        }
+
+        tick(dt * m_timeScale);
+
+        ticks++;
+        simulated += dt;
+        Metrics::update();
+
+        if (throttled) {
+            m_pacer.wait();
+        }
+    }
+
+    const float wall = wallClock.getElapsedTime().asSeconds();
+    spdlog::info("Simulated {} ticks ({:.2f} s) in {:.2f} s of wall time",
+                 ticks, simulated, wall);
+    spdlog::info("Tick time p50 {:.3f} ms, p99 {:.3f} ms, p999 {:.3f} ms",
+                 tickTimes.getPercentile(0.5f) * 1000.0f,
+                 tickTimes.getPercentile(0.99f) * 1000.0f,
+                 tickTimes.getPercentile(0.999f) * 1000.0f);
+    spdlog::info("Deferred ticks: {}", m_deferredTicks);
+
+    delete m_gameState;
+    m_gameState = nullptr;
+}
+
+bool Game::executeFluidBench() {
+    loadAssets();
+    Counter& cellUpdates = Metrics::getCounter("fluids.cell_updates");
+    spdlog::info("Flooding {0}x{0} chunks with a source every {1} tiles",
+                 FLUID_BENCH_CHUNKS, FLUID_BENCH_SPACING);
+
+    const unsigned int first = Map::CHUNK_NO / 2 - FLUID_BENCH_CHUNKS / 2;
+    const unsigned int last  = first + FLUID_BENCH_CHUNKS;
+    const unsigned int begin = first * Chunk::CHUNK_SIZE;
+    const unsigned int end   = last * Chunk::CHUNK_SIZE;
+
+    // The same flood stepped on this thread only and then on the pool, both
+    // have to settle into the same world
+    std::uint64_t hashes[2] = {};
+    for (const bool parallel : {false, true}) {
+        OverworldGenerator gen(m_settings.debug.testSeed);
+        Map map(&gen);
+        for (unsigned int y = first; y < last; y++) {
+            for (unsigned int x = first; x < last; x++) {
+                map.generateChunk(x, y);
+            }
+        }
+
+        Fluids& fluids = map.getFluids();
+        fluids.setParallel(parallel);
+        for (unsigned int y = begin; y < end; y += FLUID_BENCH_SPACING) {
+            for (unsigned int x = begin; x < end; x += FLUID_BENCH_SPACING) {
+                const bool lava = (x + y) % (FLUID_BENCH_SPACING * 7) == 0;
+                fluids.placeSource(x, y, lava ? Fluid::Lava : Fluid::Water);
+            }
+        }
+
+        const std::uint64_t updatesBefore = cellUpdates.get();
+        std::vector<float> steps;
+        std::size_t peakAwake = 0;
+        sf::Clock wallClock;
+        while (!fluids.isAsleep() && steps.size() < FLUID_BENCH_MAX_STEPS) {
+            peakAwake = std::max(peakAwake, fluids.getAwakeChunkNo());
+            sf::Clock stepClock;
+            fluids.update();
+            steps.push_back(stepClock.getElapsedTime().asSeconds());
+        }
+        const float wall = wallClock.getElapsedTime().asSeconds();
+
+        Hash hash;
+        for (unsigned int y = begin; y < end; y++) {
+            for (unsigned int x = begin; x < end; x++) {
+                hash.add(fluids.getFluid(x, y));
+                hash.add(fluids.getLevel(x, y));
+            }
+        }
+        hashes[parallel] = hash.get();
+
+        if (steps.empty()) {
+            spdlog::warn("Nothing to flood, every source landed on a wall");
+            continue;
+        }
+        std::sort(steps.begin(), steps.end());
+        const auto percentile = [&steps](const float p) {
+            return steps[std::min(steps.size() - 1,
+                                  static_cast<std::size_t>(
+                                      p * static_cast<float>(steps.size())))] *
+                   1000.0f;
+        };
+        spdlog::info("{}: settled in {} steps and {:.2f} ms, {} cell updates, "
+                     "at most {} awake chunks",
+                     parallel ? "Parallel" : "Serial", steps.size(),
+                     wall * 1000.0f, cellUpdates.get() - updatesBefore,
+                     peakAwake);
+        spdlog::info("{}: step p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+                     parallel ? "Parallel" : "Serial", percentile(0.5f),
+                     percentile(0.99f), steps.back() * 1000.0f);
+    }
+
+    if (hashes[0] != hashes[1]) {
+        spdlog::error("Serial and parallel floods settled differently, "
+                      "hashes {:016x} and {:016x}",
+                      hashes[0], hashes[1]);
+        return false;
+    }
+    return true;
+}
+
+bool Game::executeReplay() {
+    ReplayReader replay(m_options.replayPath);
+
+    // The world has to be generated exactly as it was while recording
+    m_settings = replay.getSettings();
+    loadAssets();
+
+    auto* state = new PlayingState();
+    setState(state);
+    switchState();
+
+    Histogram& tickTimes = Metrics::getHistogram("game.tick_time");
+    spdlog::info("Replaying {} with seed {}", m_options.replayPath,
+                 m_settings.debug.testSeed);
+
+    sf::Clock wallClock;
+    TickInput input;
+    std::uint64_t expected;
+    unsigned long ticks = 0;
+    float simulated     = 0.0f;
+    bool diverged       = false;
+
+    while (replay.read(input, expected)) {
+        state->setTickInput(input);
+        tick(input.dt);
+
+        const std::uint64_t hash = state->getStateHash();
+        if (hash != expected) {
+            spdlog::error("Replay diverged at tick {}: expected state {:016x}, "
+                          "got {:016x}",
+                          ticks, expected, hash);
+            diverged = true;
+            break;
+        }
+
+        ticks++;
+        simulated += input.dt;
+        Metrics::update();
+    }
+
+    const float wall = wallClock.getElapsedTime().asSeconds();
+    spdlog::info("Replayed {} ticks ({:.2f} s) in {:.2f} s of wall time", ticks,
+                 simulated, wall);
+    spdlog::info("Tick time p50 {:.3f} ms, p99 {:.3f} ms, p999 {:.3f} ms",
+                 tickTimes.getPercentile(0.5f) * 1000.0f,
+                 tickTimes.getPercentile(0.99f) * 1000.0f,
+                 tickTimes.getPercentile(0.999f) * 1000.0f);
+    if (!diverged) {
+        spdlog::info("Every tick matched the recorded world state");
+    }
+
+    delete m_gameState;
+    m_gameState = nullptr;
+
+    return !diverged;
+}
+
+void Game::tick(const float dt) {
+    static Histogram& tickTimes = Metrics::getHistogram("game.tick_time");
+
+    // Menus have no state worth replaying, only the world is recorded
+    auto* playing = m_recorder.isOpen()
+                        ? dynamic_cast<PlayingState*>(m_gameState)
+                        : nullptr;
+    TickInput input;
+    if (playing != nullptr) {
+        input    = playing->getTickInput();
+        input.dt = dt;
+    }
+
+    m_tickDeferred = false;
+    m_tickClock.restart();
+    m_gameState->update(dt);
+    tickTimes.record(m_tickClock.getElapsedTime().asSeconds());
+    if (m_tickDeferred) {
+        m_deferredTicks++;
+    }
+
+    if (playing != nullptr) {
+        m_recorder.write(input, playing->getStateHash());
+    }
+}
+
+void Game::switchState() {
+    if (m_requestedState == nullptr) {
+        return;
+    }
 
-    std::ifstream i("settings.json");
-    i >> m_settings;
+    delete m_gameState;
+    m_gameState      = m_requestedState;
+    m_requestedState = nullptr;
 
-    i.close();
+    // A replay holds a single world, from its creation onwards
+    if (m_recorder.getTicks() > 0) {
+        m_recorder.close();
+    }
 }
 
-void Game::createDefaultSettings() {
-    m_settings.clear();
-    // Display settings
-    m_settings["display"]["resolution_x"] = 1280;
-    m_settings["display"]["resolution_y"] = 720;
-    m_settings["display"]["window_type"]  = "window";
-    // Control settings
-    m_settings["controls"]["toggle_console"] = sf::Keyboard::Tilde;
-    m_settings["controls"]["move_up"]        = sf::Keyboard::W;
-    m_settings["controls"]["move_down"]      = sf::Keyboard::S;
-    m_settings["controls"]["move_left"]      = sf::Keyboard::A;
-    m_settings["controls"]["move_right"]     = sf::Keyboard::D;
-    // Debug settings
-    m_settings["debug"]["test_seed"] = 7582;
+void Game::loadSettings() {
+    nlohmann::json j;
+
+    try {
+        std::ifstream i("settings.json");
+        i >> j;
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::error("Could not parse settings.json: {}", e.what());
+        spdlog::warn("Using default settings!");
+    }
+
+    m_settings = Settings::fromJson(j);
 }
 
-void Game::loadTextures() {
-    PHYSFS_enumerate("/textures", loadTextureCallback, NULL);
+void Game::applySettings(const Settings& settings) {
+    m_actions = ActionMap(settings.controls);
+
+    if (m_win != nullptr) {
+        m_win->setVerticalSyncEnabled(settings.display.vsync);
+    }
+
+    Metrics::setDumpInterval(settings.debug.metricsDumpInterval,
+                             settings.debug.metricsDumpPath);
 }
 
-void Game::loadItems() {
-    PHYSFS_enumerate("/items", loadItemCallback, NULL);
+void Game::loadAssets() {
+    if (loadAssetPack()) {
+        return;
+    }
+
+    // Textures are never uploaded without a GL context
+    AssetLoader loader(m_pool, !m_options.headless, getAssetCacheDir());
+    loader.finish();
 }
 
-void Game::loadTiles() {
-    PHYSFS_enumerate("/tiles", loadTileCallback, NULL);
+bool Game::loadAssetPack() {
+#ifndef NC_DEBUG
+    if (m_options.noPack) {
+        return false;
+    }
+
+    AssetPack pack;
+    if (!pack.open(ASSET_PACK_PATH)) {
+        return false;
+    }
+
+    AssetLoader::loadPack(pack, !m_options.headless);
+    return true;
+#else
+    // Debug builds always read the loose files, so edits show up directly
+    return false;
+#endif
 }
 
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 #include <Game/GameRegistry.hpp>
 #include <Game/Item.hpp>
+#include <Game/Prefab.hpp>
 #include <World/Tile.hpp>
 
 namespace nc {
@@ -28,6 +29,10 @@ GameRegistry::~GameRegistry() {
     for (auto& t : m_tiles) {
         delete t.second;
     }
+
+    for (auto& p : m_prefabs) {
+        delete p.second;
+    }
 }
 
 void GameRegistry::registerItem(Item* item) {
@@ -35,7 +40,26 @@ void GameRegistry::registerItem(Item* item) {
 }
 
 void GameRegistry::registerTile(Tile* tile) {
-    m_tiles[tile->getName()] = tile;
+    const std::string name = tile->getName();
+    if (auto it = m_behaviours.find(name); it != m_behaviours.end()) {
+        tile->setBehaviour(&it->second);
+    }
+
+    m_tiles[name] = tile;
+}
+
+void GameRegistry::registerPrefab(Prefab* prefab) {
+    m_prefabs[prefab->getName()] = prefab;
+}
+
+void GameRegistry::registerTileBehaviour(const std::string& tile,
+                                         TileBehaviour behaviour) {
+    // Map nodes never move, so tiles can keep pointing at their behaviour
+    TileBehaviour& b = m_behaviours[tile];
+    b                = std::move(behaviour);
+    if (Tile* t = getTile(tile); t != nullptr) {
+        t->setBehaviour(&b);
+    }
 }
 
 Item* GameRegistry::getItem(const std::string& name) {
@@ -54,4 +78,12 @@ Tile* GameRegistry::getTile(const std::string& name) {
     return m_tiles[name];
 }
 
+Prefab* GameRegistry::getPrefab(const std::string& name) {
+    if (m_prefabs.find(name) == m_prefabs.end()) {
+        return nullptr;
+    }
+
+    return m_prefabs[name];
+}
+
 }
\ No newline at end of file
@@ -18,4 +18,12 @@ namespace nc {
 
 GameState::~GameState() {}
 
+bool GameState::isIdle() const {
+    return false;
+}
+
+void GameState::onTextureReloaded(const sf::Texture&) {}
+
+void GameState::onTileReloaded(Tile*) {}
+
 }
\ No newline at end of file
@@ -27,6 +27,10 @@ Item::Item(const std::string& texture, const std::string& name)
 }
 
 void Item::setTexture(const std::string& texture) {
+    if (Game::getInstance()->isHeadless()) {
+        return;
+    }
+
     m_sprite.setTexture(
         Game::getInstance()->getTextureAtlas().getTexture(texture));
     m_sprite.setScale(
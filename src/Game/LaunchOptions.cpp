@@ -0,0 +1,84 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/LaunchOptions.hpp>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+float parseFloat(const std::string& arg, const std::string& value) {
+    try {
+        std::size_t end;
+        const float f = std::stof(value, &end);
+        if (end == value.size() && f >= 0.0f) {
+            return f;
+        }
+    } catch (const std::logic_error&) {
+    }
+
+    throw std::runtime_error("Invalid value for " + arg + ": " + value);
+}
+
+}
+
+namespace nc {
+
+LaunchOptions LaunchOptions::parse(int argc, char** argv) {
+    LaunchOptions opt;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const std::size_t eq  = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value =
+            eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+
+        if (key == "--headless") {
+            opt.headless = true;
+        } else if (key == "--tick-rate") {
+            opt.tickRate = parseFloat(key, value);
+        } else if (key == "--duration") {
+            opt.duration = parseFloat(key, value);
+        } else if (key == "--walk-speed") {
+            opt.walkSpeed = parseFloat(key, value);
+        } else if (key == "--no-pack") {
+            opt.noPack = true;
+        } else if (key == "--no-cache") {
+            opt.noCache = true;
+        } else if (key == "--startup-bench") {
+            opt.startupBench = true;
+        } else if (key == "--fluid-bench") {
+            opt.fluidBench = true;
+            opt.headless   = true;
+        } else if (key == "--record" && !value.empty()) {
+            opt.recordPath = value;
+        } else if (key == "--replay" && !value.empty()) {
+            opt.replayPath = value;
+            opt.headless   = true;
+        } else {
+            spdlog::warn("Unknown argument {}", arg);
+        }
+    }
+
+    if (opt.startupBench && opt.headless) {
+        spdlog::warn("--startup-bench needs a window, ignoring it");
+        opt.startupBench = false;
+    }
+
+    return opt;
+}
+
+}
@@ -0,0 +1,71 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/LoadingState.hpp>
+#include <Game/Game.hpp>
+#include <Game/MainMenuState.hpp>
+#include <UI/UI.hpp>
+
+namespace {
+    constexpr float BAR_WIDTH  = 400.0f;
+    constexpr float BAR_HEIGHT = 12.0f;
+}
+
+namespace nc {
+
+LoadingState::LoadingState()
+    : m_loader(Game::getInstance()->getThreadPool(), true,
+               Game::getInstance()->getAssetCacheDir()),
+      m_view(sf::FloatRect(0.0f, 0.0f, UI::REFERENCE_WIDTH,
+                           UI::REFERENCE_HEIGHT)),
+      m_done(false) {
+    const sf::Vector2f pos((UI::REFERENCE_WIDTH - BAR_WIDTH) / 2.0f,
+                           (UI::REFERENCE_HEIGHT - BAR_HEIGHT) / 2.0f);
+    m_back.setPosition(pos);
+    m_back.setSize(sf::Vector2f(BAR_WIDTH, BAR_HEIGHT));
+    m_back.setFillColor(sf::Color(40, 40, 40));
+    m_bar.setPosition(pos);
+    m_bar.setFillColor(sf::Color(90, 170, 60));
+}
+
+void LoadingState::perFrame() {
+    if (m_done) {
+        return;
+    }
+
+    m_done = m_loader.update(FRAME_BUDGET);
+    m_bar.setSize(
+        sf::Vector2f(BAR_WIDTH * m_loader.getProgress(), BAR_HEIGHT));
+
+    if (m_done) {
+        Game::getInstance()->markStartupPhase("assets");
+        Game::getInstance()->setState(new MainMenuState());
+        Game::getInstance()->markStartupPhase("main_menu");
+    }
+}
+
+void LoadingState::handleEvent(sf::Event e) {}
+
+void LoadingState::update(const float dt) {}
+
+void LoadingState::draw(sf::RenderWindow& win) {
+    const sf::View v = win.getView();
+
+    win.setView(m_view);
+    win.draw(m_back);
+    win.draw(m_bar);
+    win.setView(v);
+}
+
+}
@@ -15,6 +15,7 @@
 #include <Game/MainMenuState.hpp>
 #include <Game/Game.hpp>
 #include <Game/PlayingState.hpp>
+#include <General/Profiler.hpp>
 
 namespace nc {
 
@@ -23,6 +24,7 @@ MainMenuState::MainMenuState() {
 }
 
 void MainMenuState::perFrame() {
+    NC_PROFILE_SCOPE("UI update");
     m_mainMenu.update();
 }
 
@@ -36,4 +38,8 @@ void MainMenuState::draw(sf::RenderWindow& win) {
     win.draw(m_mainMenu);
 }
 
+bool MainMenuState::isIdle() const {
+    return true;
+}
+
 }
\ No newline at end of file
@@ -14,45 +14,35 @@
 
 #include <Game/PlayingState.hpp>
 #include <Game/Game.hpp>
+#include <Game/Prefab.hpp>
 #include <General/Object.hpp>
 #include <General/InputHandler.hpp>
 #include <Components/PlayerInputComponent.hpp>
-#include <Components/PlayerComponent.hpp>
 #include <Components/VelocityComponent.hpp>
 #include <Components/InventoryComponent.hpp>
-#include <Components/AnimationComponent.hpp>
-#include <Components/CollisionBoxComponent.hpp>
+#include <UI/PlayerInventory.hpp>
 #include <General/Physics.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <General/Hash.hpp>
+#include <stdexcept>
 
 namespace nc {
 
 PlayingState::PlayingState()
-    : m_gen(new OverworldGenerator(Game::getInstance()
-                                       ->getSettings()["debug"]["test_seed"]
-                                       .get<unsigned int>())),
-      m_map(new Map(m_gen)) {
+    : m_gen(new OverworldGenerator(
+          Game::getInstance()->getSettings().debug.testSeed)),
+      m_map(new Map(m_gen)), m_editHash(Hash::OFFSET) {
+    const Prefab* player =
+        Game::getInstance()->getRegistry().getPrefab("player");
+    if (player == nullptr) {
+        throw std::runtime_error("Could not find the player prefab!");
+    }
+
     entt::registry& reg = m_map->getRegistry();
-    m_player            = reg.create();
-    reg.emplace<Object>(m_player, "player.png");
-    reg.emplace<PlayerComponent>(m_player);
-    reg.emplace<PlayerInputComponent>(m_player);
-    reg.emplace<VelocityComponent>(m_player);
+    m_player = player->spawn(reg, sf::Vector2f(16400.0f, 16400.0f));
     reg.emplace<sf::View*>(m_player, &Game::getInstance()->getView());
-    reg.emplace<InventoryComponent>(m_player, PlayerInventory::PLAYER_INV_SIZE);
-    reg.emplace<AnimationComponent>(m_player, entt::handle(reg, m_player));
-    reg.emplace<CollisionBoxComponent>(m_player);
-    reg.get<Object>(m_player).setPosition(sf::Vector2f(16400.0f, 16400.0f));
     reg.get<sf::View*>(m_player)->setCenter(16400.0f, 16400.0f);
-    reg.get<Object>(m_player).setSize(sf::Vector2u(1, 2));
-    reg.get<AnimationComponent>(m_player).setFramerate(6.0f);
-    reg.get<AnimationComponent>(m_player).setFrameSize(sf::Vector2i(16, 32));
-    reg.get<AnimationComponent>(m_player).addAnimation("idle", sf::Vector2i(0, 0), 4, true);
-    reg.get<AnimationComponent>(m_player).addAnimation("walk_up", sf::Vector2i(0, 32), 4, true);
-    reg.get<AnimationComponent>(m_player).addAnimation("walk_down", sf::Vector2i(0, 64), 4, true);
-    reg.get<AnimationComponent>(m_player).addAnimation("walk_right", sf::Vector2i(0, 96), 4, true);
-    reg.get<AnimationComponent>(m_player).addAnimation("walk_left", sf::Vector2i(0, 128), 4, true);
-    reg.get<AnimationComponent>(m_player).startAnimation("idle", true);
-    reg.get<CollisionBoxComponent>(m_player).box = sf::FloatRect(16400.0f, 16401.0f, 1.0f, 1.0f);
     m_playerInventory.setPlayer({reg, m_player});
     m_playerUI.setPlayer({reg, m_player});
     m_playerInventory.setShown(false);
@@ -65,7 +55,7 @@ PlayingState::~PlayingState() {
 }
 
 void PlayingState::perFrame() {
-    InputHandler::pollInput(m_map->getRegistry());
+    NC_PROFILE_SCOPE("UI update");
     m_playerUI.update();
     m_playerInventory.update();
 }
@@ -76,33 +66,22 @@ void PlayingState::handleEvent(sf::Event e) {
     m_playerInventory.handleEvent(e);
 
     // TODO: Remove
-    if (e.type == sf::Event::MouseButtonReleased) {
-        if (e.mouseButton.button == sf::Mouse::Left) {
-            ItemStack& s =
-                m_map->getRegistry()
-                    .get<InventoryComponent>(m_player)
-                    .inventory[9 * 4 + m_playerUI.getSelectedHotbarItem()];
-            if (!s.isEmpty()) {
-                sf::Vector2i mousePos{e.mouseButton.x, e.mouseButton.y};
-                sf::Vector2f worldPos =
-                    Game::getInstance()->getWindow().mapPixelToCoords(
-                        mousePos, Game::getInstance()->getView());
-                m_map->placeTile(Game::getInstance()->getRegistry().getTile("grass"), worldPos.x, worldPos.y);
-                s.setCount(s.getCount() - 1);
-            }
-        } else if (e.mouseButton.button == sf::Mouse::Right) {
-            ItemStack& s =
-                m_map->getRegistry()
-                    .get<InventoryComponent>(m_player)
-                    .inventory[9 * 4 + m_playerUI.getSelectedHotbarItem()];
-            if (s.isEmpty()) {
-                s.setItem(Game::getInstance()->getRegistry().getItem("grass"));
-            } else {
-                s.setCount(s.getCount() + 1);
-            }
-        }
+    if (e.type == sf::Event::MouseButtonReleased &&
+        (e.mouseButton.button == sf::Mouse::Left ||
+         e.mouseButton.button == sf::Mouse::Right)) {
+        sf::Vector2i mousePos{e.mouseButton.x, e.mouseButton.y};
+        WorldEdit edit;
+        edit.type = e.mouseButton.button == sf::Mouse::Left
+                        ? WorldEdit::Type::PlaceTile
+                        : WorldEdit::Type::AddItem;
+        edit.slot = static_cast<std::uint8_t>(
+            m_playerUI.getSelectedHotbarItem());
+        edit.pos = Game::getInstance()->getWindow().mapPixelToCoords(
+            mousePos, Game::getInstance()->getView());
+        m_edits.push_back(edit);
     } else if (e.type == sf::Event::KeyReleased) {
-        if (e.key.code == sf::Keyboard::E) {
+        if (Game::getInstance()->getActionMap().getAction(e.key.code) ==
+            Action::ToggleInventory) {
             m_playerInventory.setShown(!m_playerInventory.getShown());
         }
     } else if (e.type == sf::Event::MouseWheelScrolled) {
@@ -118,13 +97,103 @@ void PlayingState::handleEvent(sf::Event e) {
 }
 
 void PlayingState::update(const float dt) {
+    // Input is applied per tick so movement does not depend on frame rate
+    InputHandler::processInput(m_map->getRegistry());
+    for (const WorldEdit& edit : m_edits) {
+        applyEdit(edit);
+    }
+    m_edits.clear();
+
+    // Decide which entities are stepped this tick
+    m_map->getLod().update(m_map->getRegistry(), dt);
     // Simulate physics
-    Physics::simulate(m_map->getRegistry(), dt, m_map);
+    Physics::simulate(m_map->getRegistry(), m_map);
     // Simulate world
     m_map->simulateWorld(dt);
+
+    static Gauge& entities = Metrics::getGauge("world.entities");
+    entities.set(static_cast<std::int64_t>(m_map->getRegistry().alive()));
+}
+
+entt::handle PlayingState::getPlayer() {
+    return {m_map->getRegistry(), m_player};
+}
+
+TickInput PlayingState::getTickInput() const {
+    const auto& in = m_map->getRegistry().get<PlayerInputComponent>(m_player);
+
+    TickInput input;
+    input.held     = in.held;
+    input.pressed  = in.pressed;
+    input.released = in.released;
+    input.edits    = m_edits;
+    return input;
+}
+
+void PlayingState::setTickInput(const TickInput& input) {
+    auto& in    = m_map->getRegistry().get<PlayerInputComponent>(m_player);
+    in.held     = input.held;
+    in.pressed  = input.pressed;
+    in.released = input.released;
+    m_edits     = input.edits;
+}
+
+std::uint64_t PlayingState::getStateHash() const {
+    entt::registry& reg = m_map->getRegistry();
+    Hash h;
+
+    h.add(reg.alive());
+    h.add(m_editHash);
+    reg.view<const Object>().each([&](auto e, const auto& obj) {
+        h.add(e);
+        h.add(obj.getPosition());
+    });
+    reg.view<const VelocityComponent>().each([&](auto e, const auto& vel) {
+        h.add(e);
+        h.add(vel.velocity);
+    });
+
+    const auto& inv = reg.get<InventoryComponent>(m_player);
+    for (unsigned int i = 0; i < inv.getSize(); i++) {
+        const ItemStack& s = inv.getSlot(i);
+        h.add(s.getCount());
+        if (!s.isEmpty()) {
+            h.add(s.getItem()->getName());
+        }
+    }
+
+    return h.get();
+}
+
+void PlayingState::applyEdit(const WorldEdit& edit) {
+    ItemStack& s = m_map->getRegistry()
+                       .get<InventoryComponent>(m_player)
+                       .getSlot(PlayerInventory::HOTBAR_START + edit.slot);
+
+    if (edit.type == WorldEdit::Type::PlaceTile) {
+        if (!s.isEmpty()) {
+            m_map->placeTile(
+                Game::getInstance()->getRegistry().getTile("grass"),
+                edit.pos.x, edit.pos.y);
+            s.setCount(s.getCount() - 1);
+
+            Hash h;
+            h.add(m_editHash);
+            h.add(edit.pos);
+            m_editHash = h.get();
+        }
+    } else {
+        if (s.isEmpty()) {
+            s.setItem(Game::getInstance()->getRegistry().getItem("grass"));
+        } else if (s.getCount() < ItemStack::MAX_COUNT) {
+            s.setCount(s.getCount() + 1);
+        }
+    }
 }
 
 void PlayingState::draw(sf::RenderWindow& win) {
+    NC_PROFILE_SCOPE("PlayingState::draw");
+    static Counter& drawCalls = Metrics::getCounter("render.draw_calls");
     unsigned int chunkX =
         Map::getChunkPos(
             m_map->getRegistry().get<Object>(m_player).getPosition())
@@ -170,10 +239,24 @@ void PlayingState::draw(sf::RenderWindow& win) {
     if (c8 != nullptr) {
         win.draw(*c8);
     }
+    const sf::View& view = win.getView();
+    m_map->getItemDrops().draw(
+        m_map->getRegistry(), win,
+        sf::FloatRect(view.getCenter() - view.getSize() / 2.0f,
+                      view.getSize()));
     win.draw(m_map->getRegistry().get<Object>(m_player));
+    drawCalls.add();
     // Draw ui
     win.draw(m_playerUI);
     win.draw(m_playerInventory);
 }
 
+void PlayingState::onTextureReloaded(const sf::Texture& texture) {
+    m_map->refreshTexture(&texture);
+}
+
+void PlayingState::onTileReloaded(Tile* tile) {
+    m_map->refreshTile(tile);
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/Prefab.hpp>
+#include <Game/Game.hpp>
+#include <Components/PlayerComponent.hpp>
+#include <Components/PlayerInputComponent.hpp>
+#include <Components/VelocityComponent.hpp>
+#include <Components/InventoryComponent.hpp>
+#include <Components/CollisionBoxComponent.hpp>
+#include <Components/SteeringComponent.hpp>
+#include <General/Profiler.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+
+namespace nc {
+
+Prefab::Prefab(const PrefabDef& def)
+    : m_name(def.name), m_components(def.components),
+      m_object(def.texture, sf::Vector2u(def.width, def.height)),
+      m_box(def.boxX, def.boxY, def.boxWidth, def.boxHeight),
+      m_inventory(std::min(def.inventorySize, InventoryComponent::CAPACITY)),
+      m_steeringSpeed(def.steeringSpeed) {
+    if (def.inventorySize > InventoryComponent::CAPACITY) {
+        spdlog::warn("Prefab {} asks for {} inventory slots, clamped to {}",
+                     def.name, def.inventorySize, InventoryComponent::CAPACITY);
+    }
+    if (has(PrefabDef::Animation)) {
+        const AnimationLibrary& lib = Game::getInstance()->getAnimations();
+        m_animation.clip            = lib.getId(def.clip);
+        if (m_animation.clip != AnimationLibrary::NO_CLIP) {
+            const AnimationClip& clip = lib.get(m_animation.clip);
+            m_object.setTextureRect(
+                sf::IntRect(clip.firstFrame, clip.frameSize));
+        }
+    }
+}
+
+const std::string& Prefab::getName() const {
+    return m_name;
+}
+
+entt::entity Prefab::spawn(entt::registry& reg, const sf::Vector2f pos) const {
+    entt::entity e;
+    spawn(reg, &pos, 1, &e);
+    return e;
+}
+
+void Prefab::spawn(entt::registry& reg, const sf::Vector2f* positions,
+                   const std::size_t count, entt::entity* out) const {
+    NC_PROFILE_FUNCTION();
+    entt::entity* const last = out + count;
+
+    reg.create(out, last);
+    reg.insert<Object>(out, last, m_object);
+    if (has(PrefabDef::Velocity)) {
+        reg.insert<VelocityComponent>(out, last);
+    }
+    if (has(PrefabDef::CollisionBox)) {
+        reg.insert<CollisionBoxComponent>(out, last);
+    }
+    if (has(PrefabDef::Animation)) {
+        reg.insert<AnimationComponent>(out, last, m_animation);
+    }
+    if (has(PrefabDef::Player)) {
+        reg.insert<PlayerComponent>(out, last);
+        reg.insert<PlayerInputComponent>(out, last);
+    }
+    if (has(PrefabDef::Steering)) {
+        reg.insert<SteeringComponent>(out, last,
+                                      SteeringComponent{m_steeringSpeed});
+    }
+    if (has(PrefabDef::Inventory)) {
+        reg.insert<InventoryComponent>(out, last, m_inventory);
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        reg.get<Object>(out[i]).setPosition(positions[i]);
+    }
+    if (has(PrefabDef::CollisionBox)) {
+        for (std::size_t i = 0; i < count; i++) {
+            reg.get<CollisionBoxComponent>(out[i]).box = sf::FloatRect(
+                positions[i].x + m_box.left, positions[i].y + m_box.top,
+                m_box.width, m_box.height);
+        }
+    }
+}
+
+bool Prefab::has(const PrefabDef::Component component) const {
+    return (m_components & component) != 0;
+}
+
+}
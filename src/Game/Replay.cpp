@@ -0,0 +1,155 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/Replay.hpp>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace {
+
+static_assert(nc::ACTION_NO <= 16, "Action sets are stored as 16 bits");
+
+template <typename T>
+void writeValue(std::ostream& o, const T& value) {
+    o.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& i, T& value) {
+    return static_cast<bool>(
+        i.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeActions(std::ostream& o, const nc::ActionSet& set) {
+    writeValue(o, static_cast<std::uint16_t>(set.to_ulong()));
+}
+
+bool readActions(std::istream& i, nc::ActionSet& set) {
+    std::uint16_t bits;
+    if (!readValue(i, bits)) {
+        return false;
+    }
+
+    set = nc::ActionSet(bits);
+    return true;
+}
+
+}
+
+namespace nc {
+
+bool ReplayWriter::open(const std::string& path, const Settings& settings) {
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out) {
+        spdlog::error("Could not open replay file {}!", path);
+        return false;
+    }
+
+    const std::string json = settings.toJson().dump();
+    writeValue(m_out, MAGIC);
+    writeValue(m_out, VERSION);
+    writeValue(m_out, settings.debug.testSeed);
+    writeValue(m_out, static_cast<std::uint32_t>(json.size()));
+    m_out.write(json.data(), static_cast<std::streamsize>(json.size()));
+    m_ticks = 0;
+
+    spdlog::info("Recording input to {}", path);
+    return true;
+}
+
+void ReplayWriter::close() {
+    if (m_out.is_open()) {
+        m_out.close();
+        spdlog::info("Recorded {} ticks", m_ticks);
+    }
+}
+
+bool ReplayWriter::isOpen() const {
+    return m_out.is_open();
+}
+
+void ReplayWriter::write(const TickInput& input, const std::uint64_t hash) {
+    writeValue(m_out, input.dt);
+    writeActions(m_out, input.held);
+    writeActions(m_out, input.pressed);
+    writeActions(m_out, input.released);
+    writeValue(m_out, static_cast<std::uint32_t>(input.edits.size()));
+    for (const WorldEdit& e : input.edits) {
+        writeValue(m_out, e.type);
+        writeValue(m_out, e.slot);
+        writeValue(m_out, e.pos.x);
+        writeValue(m_out, e.pos.y);
+    }
+    writeValue(m_out, hash);
+
+    m_ticks++;
+}
+
+unsigned long ReplayWriter::getTicks() const {
+    return m_ticks;
+}
+
+ReplayReader::ReplayReader(const std::string& path)
+    : m_in(path, std::ios::binary) {
+    if (!m_in) {
+        throw std::runtime_error("Could not open replay file " + path + "!");
+    }
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t seed;
+    std::uint32_t size;
+    if (!readValue(m_in, magic) || magic != ReplayWriter::MAGIC ||
+        !readValue(m_in, version) || version != ReplayWriter::VERSION ||
+        !readValue(m_in, seed) || !readValue(m_in, size)) {
+        throw std::runtime_error(path + " is not a supported replay file!");
+    }
+
+    std::string json(size, '\0');
+    if (!m_in.read(&json[0], size)) {
+        throw std::runtime_error("Replay file " + path + " is truncated!");
+    }
+
+    m_settings =
+        Settings::fromJson(nlohmann::json::parse(json, nullptr, false));
+    m_settings.debug.testSeed = seed;
+}
+
+const Settings& ReplayReader::getSettings() const {
+    return m_settings;
+}
+
+bool ReplayReader::read(TickInput& input, std::uint64_t& hash) {
+    std::uint32_t editNo;
+    if (!readValue(m_in, input.dt) || !readActions(m_in, input.held) ||
+        !readActions(m_in, input.pressed) ||
+        !readActions(m_in, input.released) || !readValue(m_in, editNo)) {
+        return false;
+    }
+
+    // Grown edit by edit, a corrupt count runs out of file instead of memory
+    input.edits.clear();
+    for (std::uint32_t i = 0; i < editNo; i++) {
+        WorldEdit e;
+        if (!readValue(m_in, e.type) || !readValue(m_in, e.slot) ||
+            !readValue(m_in, e.pos.x) || !readValue(m_in, e.pos.y)) {
+            return false;
+        }
+        input.edits.push_back(e);
+    }
+
+    return readValue(m_in, hash);
+}
+
+}
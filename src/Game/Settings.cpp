@@ -0,0 +1,147 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Game/Settings.hpp>
+#include <spdlog/spdlog.h>
+
+namespace {
+
+// Reads j[section][key] into value if present and accepted by valid
+template <typename T, typename F>
+void read(const nlohmann::json& j, const char* section, const char* key,
+          T& value, F valid) {
+    const auto s = j.find(section);
+    if (s == j.end() || !s->is_object()) {
+        return;
+    }
+
+    const auto v = s->find(key);
+    if (v == s->end()) {
+        return;
+    }
+
+    try {
+        const T t = v->get<T>();
+        if (valid(t)) {
+            value = t;
+            return;
+        }
+    } catch (const nlohmann::json::exception&) {
+    }
+
+    spdlog::warn("Invalid setting {}.{}: {}, using default", section, key,
+                 v->dump());
+}
+
+template <typename T>
+void read(const nlohmann::json& j, const char* section, const char* key,
+          T& value) {
+    read(j, section, key, value, [](const T&) { return true; });
+}
+
+void readKey(const nlohmann::json& j, const char* key,
+             sf::Keyboard::Key& value) {
+    int code = value;
+    read(j, "controls", key, code, [](const int k) {
+        return k >= 0 && k < sf::Keyboard::KeyCount;
+    });
+    value = static_cast<sf::Keyboard::Key>(code);
+}
+
+bool isPositive(const unsigned int u) {
+    return u > 0;
+}
+
+const char* getWindowTypeName(const nc::WindowType type) {
+    switch (type) {
+    case nc::WindowType::Fullscreen:
+        return "fullscreen";
+    case nc::WindowType::Borderless:
+        return "borderless";
+    default:
+        return "window";
+    }
+}
+
+}
+
+namespace nc {
+
+Settings Settings::fromJson(const nlohmann::json& j) {
+    Settings s;
+
+    read(j, "display", "resolution_x", s.display.resolutionX, isPositive);
+    read(j, "display", "resolution_y", s.display.resolutionY, isPositive);
+    read(j, "display", "vsync", s.display.vsync);
+    read(j, "display", "fps_cap", s.display.fpsCap);
+    read(j, "display", "idle_fps", s.display.idleFps, isPositive);
+
+    std::string windowType = getWindowTypeName(s.display.windowType);
+    read(j, "display", "window_type", windowType,
+         [](const std::string& type) {
+             return type == "window" || type == "fullscreen" ||
+                    type == "borderless";
+         });
+    if (windowType == "fullscreen") {
+        s.display.windowType = WindowType::Fullscreen;
+    } else if (windowType == "borderless") {
+        s.display.windowType = WindowType::Borderless;
+    } else {
+        s.display.windowType = WindowType::Window;
+    }
+
+    readKey(j, "toggle_console", s.controls.toggleConsole);
+    readKey(j, "move_up", s.controls.moveUp);
+    readKey(j, "move_down", s.controls.moveDown);
+    readKey(j, "move_left", s.controls.moveLeft);
+    readKey(j, "move_right", s.controls.moveRight);
+    readKey(j, "sprint", s.controls.sprint);
+    readKey(j, "sneak", s.controls.sneak);
+    readKey(j, "toggle_inventory", s.controls.toggleInventory);
+
+    read(j, "debug", "test_seed", s.debug.testSeed);
+    read(j, "debug", "metrics_dump_interval", s.debug.metricsDumpInterval,
+         [](const float f) { return f >= 0.0f; });
+    read(j, "debug", "metrics_dump_path", s.debug.metricsDumpPath);
+
+    return s;
+}
+
+nlohmann::json Settings::toJson() const {
+    nlohmann::json j;
+    // Display settings
+    j["display"]["resolution_x"] = display.resolutionX;
+    j["display"]["resolution_y"] = display.resolutionY;
+    j["display"]["window_type"]  = getWindowTypeName(display.windowType);
+    j["display"]["vsync"]        = display.vsync;
+    j["display"]["fps_cap"]      = display.fpsCap;
+    j["display"]["idle_fps"]     = display.idleFps;
+    // Control settings
+    j["controls"]["toggle_console"]   = controls.toggleConsole;
+    j["controls"]["move_up"]          = controls.moveUp;
+    j["controls"]["move_down"]        = controls.moveDown;
+    j["controls"]["move_left"]        = controls.moveLeft;
+    j["controls"]["move_right"]       = controls.moveRight;
+    j["controls"]["sprint"]           = controls.sprint;
+    j["controls"]["sneak"]            = controls.sneak;
+    j["controls"]["toggle_inventory"] = controls.toggleInventory;
+    // Debug settings
+    j["debug"]["test_seed"]             = debug.testSeed;
+    j["debug"]["metrics_dump_interval"] = debug.metricsDumpInterval;
+    j["debug"]["metrics_dump_path"]     = debug.metricsDumpPath;
+
+    return j;
+}
+
+}
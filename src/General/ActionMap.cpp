@@ -0,0 +1,74 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/ActionMap.hpp>
+#include <Game/Settings.hpp>
+
+namespace nc {
+
+ActionMap::ActionMap() {
+    m_actions.fill(Action::None);
+    m_keys.fill(sf::Keyboard::Unknown);
+}
+
+ActionMap::ActionMap(const ControlSettings& controls) : ActionMap() {
+    bind(Action::MoveUp, controls.moveUp);
+    bind(Action::MoveDown, controls.moveDown);
+    bind(Action::MoveLeft, controls.moveLeft);
+    bind(Action::MoveRight, controls.moveRight);
+    bind(Action::Sprint, controls.sprint);
+    bind(Action::Sneak, controls.sneak);
+    bind(Action::ToggleInventory, controls.toggleInventory);
+    bind(Action::ToggleConsole, controls.toggleConsole);
+}
+
+void ActionMap::bind(const Action action, const sf::Keyboard::Key key) {
+    if (action == Action::None) {
+        return;
+    }
+
+    const auto a = static_cast<std::size_t>(action);
+
+    // Unbind whatever used the key and whatever key the action used
+    if (m_keys[a] != sf::Keyboard::Unknown) {
+        m_actions[m_keys[a]] = Action::None;
+    }
+    if (key != sf::Keyboard::Unknown) {
+        const Action old = m_actions[key];
+        if (old != Action::None) {
+            m_keys[static_cast<std::size_t>(old)] = sf::Keyboard::Unknown;
+        }
+        m_actions[key] = action;
+    }
+
+    m_keys[a] = key;
+}
+
+sf::Keyboard::Key ActionMap::getKey(const Action action) const {
+    if (action == Action::None) {
+        return sf::Keyboard::Unknown;
+    }
+
+    return m_keys[static_cast<std::size_t>(action)];
+}
+
+Action ActionMap::getAction(const sf::Keyboard::Key key) const {
+    if (key < 0 || key >= sf::Keyboard::KeyCount) {
+        return Action::None;
+    }
+
+    return m_actions[key];
+}
+
+}
@@ -0,0 +1,112 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AnimationSystem.hpp>
+#include <Components/AnimationComponent.hpp>
+#include <Components/PlayerComponent.hpp>
+#include <Components/LodComponent.hpp>
+#include <General/Object.hpp>
+#include <General/Profiler.hpp>
+#include <Game/Game.hpp>
+
+namespace nc {
+
+void AnimationSystem::play(entt::handle entity, const ClipId clip,
+                           const bool force) {
+    if (clip == AnimationLibrary::NO_CLIP) {
+        return;
+    }
+
+    AnimationComponent& ac = entity.get<AnimationComponent>();
+    if (!force && ac.clip != AnimationLibrary::NO_CLIP) {
+        ac.requested = clip;
+        return;
+    }
+
+    ac.clip      = clip;
+    ac.requested = AnimationLibrary::NO_CLIP;
+    ac.frame     = 0;
+    ac.accum     = 0.0f;
+
+    if (Object* o = entity.try_get<Object>(); o != nullptr) {
+        showFrame(ac, *o, Game::getInstance()->getAnimations().get(clip));
+    }
+}
+
+void AnimationSystem::update(entt::registry& reg, const bool deferred) {
+    NC_PROFILE_FUNCTION();
+    const AnimationLibrary& lib = Game::getInstance()->getAnimations();
+
+    reg.view<AnimationComponent, Object, const LodComponent, PlayerComponent>()
+        .each([&](auto& ac, auto& obj, const auto& lod) {
+            step(ac, obj, lib, lod.step);
+        });
+
+    if (deferred) {
+        return;
+    }
+
+    // Frames nobody sees are skipped, not caught up later
+    reg.view<AnimationComponent, Object, const LodComponent>(
+           entt::exclude<PlayerComponent>)
+        .each([&](auto& ac, auto& obj, const auto& lod) {
+            if (lod.visible && lod.step > 0.0f) {
+                step(ac, obj, lib, lod.step);
+            }
+        });
+}
+
+void AnimationSystem::step(AnimationComponent& ac, Object& obj,
+                           const AnimationLibrary& lib, const float dt) {
+    if (ac.clip == AnimationLibrary::NO_CLIP) {
+        return;
+    }
+
+    const AnimationClip* clip = &lib.get(ac.clip);
+    const std::uint16_t shown = ac.frame;
+    const ClipId shownClip    = ac.clip;
+
+    ac.accum += dt;
+    while (ac.accum >= clip->frameTime) {
+        ac.accum -= clip->frameTime;
+        if (ac.frame + 1u < clip->frames) {
+            ac.frame++;
+        } else if (ac.requested != AnimationLibrary::NO_CLIP) {
+            ac.clip      = ac.requested;
+            ac.requested = AnimationLibrary::NO_CLIP;
+            ac.frame     = 0;
+            clip         = &lib.get(ac.clip);
+        } else if (clip->repeated) {
+            ac.frame = 0;
+        } else {
+            // Stop on the last frame
+            ac.clip  = AnimationLibrary::NO_CLIP;
+            ac.accum = 0.0f;
+            break;
+        }
+    }
+
+    if (ac.frame != shown || ac.clip != shownClip) {
+        showFrame(ac, obj, *clip);
+    }
+}
+
+void AnimationSystem::showFrame(const AnimationComponent& ac, Object& obj,
+                                const AnimationClip& clip) {
+    obj.setTextureRect(sf::IntRect(
+        clip.firstFrame.x + static_cast<int>(ac.frame) * clip.frameSize.x,
+        clip.firstFrame.y, clip.frameSize.x, clip.frameSize.y));
+}
+
+}
@@ -0,0 +1,71 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/Arena.hpp>
+#include <cassert>
+#include <cstdint>
+
+namespace nc {
+
+Arena::Arena(const std::size_t blockSize)
+    : m_blockSize(blockSize), m_pos(nullptr), m_end(nullptr), m_used(0),
+      m_reserved(0) {}
+
+void* Arena::allocate(const std::size_t size, const std::size_t align) {
+    assert(align <= MAX_ALIGN && (align & (align - 1)) == 0);
+
+    const auto pos   = reinterpret_cast<std::uintptr_t>(m_pos);
+    const auto start = (pos + align - 1) & ~(align - 1);
+    if (m_pos != nullptr &&
+        start + size <= reinterpret_cast<std::uintptr_t>(m_end)) {
+        m_pos = reinterpret_cast<unsigned char*>(start + size);
+        m_used += size;
+        return reinterpret_cast<void*>(start);
+    }
+
+    // Blocks come from operator new[], aligned for anything up to MAX_ALIGN,
+    // and are left uninitialized so untouched pages are never faulted in
+    if (size > m_blockSize) {
+        // Kept in front so the current block stays the last one
+        m_blocks.emplace(m_blocks.begin(), new unsigned char[size]);
+        m_used += size;
+        m_reserved += size;
+        return m_blocks.front().get();
+    }
+
+    m_blocks.emplace_back(new unsigned char[m_blockSize]);
+    m_pos = m_blocks.back().get() + size;
+    m_end = m_blocks.back().get() + m_blockSize;
+    m_used += size;
+    m_reserved += m_blockSize;
+    return m_blocks.back().get();
+}
+
+void Arena::release() {
+    m_blocks.clear();
+    m_pos      = nullptr;
+    m_end      = nullptr;
+    m_used     = 0;
+    m_reserved = 0;
+}
+
+std::size_t Arena::getUsed() const {
+    return m_used;
+}
+
+std::size_t Arena::getReserved() const {
+    return m_reserved;
+}
+
+}
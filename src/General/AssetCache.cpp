@@ -0,0 +1,355 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AssetCache.hpp>
+#include <General/Hash.hpp>
+#include <General/MappedFile.hpp>
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class PayloadWriter {
+public:
+    explicit PayloadWriter(std::vector<char>& out) : m_out(out) {}
+
+    template <typename T>
+    void write(const T& value) {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        m_out.insert(m_out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(const std::string& str) {
+        write(static_cast<std::uint32_t>(str.size()));
+        m_out.insert(m_out.end(), str.begin(), str.end());
+    }
+
+    void write(const void* data, const std::size_t size) {
+        const auto* bytes = static_cast<const char*>(data);
+        m_out.insert(m_out.end(), bytes, bytes + size);
+    }
+
+private:
+    std::vector<char>& m_out;
+};
+
+// Bounds checked reads, a truncated or corrupt entry is just a miss
+class PayloadReader {
+public:
+    PayloadReader(const unsigned char* data, const std::size_t size)
+        : m_data(data), m_size(size), m_pos(0) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (m_size - m_pos < sizeof(T)) {
+            return false;
+        }
+
+        std::memcpy(&value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool read(std::string& str) {
+        std::uint32_t size;
+        if (!read(size) || m_size - m_pos < size) {
+            return false;
+        }
+
+        str.assign(reinterpret_cast<const char*>(m_data + m_pos), size);
+        m_pos += size;
+        return true;
+    }
+
+    const unsigned char* take(const std::size_t size) {
+        if (m_size - m_pos < size) {
+            return nullptr;
+        }
+
+        const unsigned char* p = m_data + m_pos;
+        m_pos += size;
+        return p;
+    }
+
+    std::size_t getRemaining() const {
+        return m_size - m_pos;
+    }
+
+    bool isDone() const {
+        return m_pos == m_size;
+    }
+
+private:
+    const unsigned char* m_data;
+    std::size_t m_size;
+    std::size_t m_pos;
+};
+
+bool readPayload(PayloadReader& r, sf::Image& img) {
+    std::uint32_t width;
+    std::uint32_t height;
+    if (!r.read(width) || !r.read(height)) {
+        return false;
+    }
+
+    const unsigned char* pixels =
+        r.take(static_cast<std::size_t>(width) * height * 4);
+    if (pixels == nullptr) {
+        return false;
+    }
+
+    img.create(width, height, pixels);
+    return true;
+}
+
+bool readPayload(PayloadReader& r, nc::TileDef& def) {
+    std::uint8_t collidable;
+    if (!r.read(def.name) || !r.read(def.texture) || !r.read(collidable)) {
+        return false;
+    }
+
+    def.collidable = collidable != 0;
+    return true;
+}
+
+bool readPayload(PayloadReader& r, nc::ItemDef& def) {
+    return r.read(def.name) && r.read(def.texture) && r.read(def.placeTile);
+}
+
+bool readPayload(PayloadReader& r, nc::AnimationSetDef& def) {
+    std::uint32_t clipNo;
+    if (!r.read(def.name) || !r.read(def.frameWidth) ||
+        !r.read(def.frameHeight) || !r.read(def.framerate) ||
+        !r.read(clipNo) || clipNo > r.getRemaining()) {
+        return false;
+    }
+
+    def.clips.resize(clipNo);
+    for (nc::AnimationClipDef& c : def.clips) {
+        std::uint8_t repeated;
+        if (!r.read(c.name) || !r.read(c.x) || !r.read(c.y) ||
+            !r.read(c.frames) || !r.read(repeated)) {
+            return false;
+        }
+        c.repeated = repeated != 0;
+    }
+
+    return true;
+}
+
+bool readPayload(PayloadReader& r, nc::PrefabDef& def) {
+    return r.read(def.name) && r.read(def.texture) && r.read(def.width) &&
+           r.read(def.height) && r.read(def.components) && r.read(def.clip) &&
+           r.read(def.boxX) && r.read(def.boxY) && r.read(def.boxWidth) &&
+           r.read(def.boxHeight) && r.read(def.inventorySize) &&
+           r.read(def.steeringSpeed);
+}
+
+}
+
+namespace nc {
+
+std::uint64_t AssetCache::getKey(const std::string& path, const char* data,
+                                 const std::size_t size) {
+    Hash h;
+    h.add(VERSION);
+    h.add(path);
+    h.add(size);
+    h.add(data, size);
+    return h.get();
+}
+
+AssetCache::AssetCache(const std::string& dir)
+    : m_dir(dir), m_enabled(!dir.empty()), m_hits(0), m_misses(0) {
+    if (!m_enabled) {
+        return;
+    }
+
+    std::error_code ec;
+    fs::create_directories(m_dir, ec);
+    if (ec) {
+        spdlog::warn("Could not create asset cache {}: {}", m_dir,
+                     ec.message());
+        m_enabled = false;
+    }
+}
+
+bool AssetCache::load(const std::uint64_t key, sf::Image& img) {
+    return loadEntry(key, Kind::Image, img);
+}
+
+bool AssetCache::load(const std::uint64_t key, TileDef& def) {
+    return loadEntry(key, Kind::Tile, def);
+}
+
+bool AssetCache::load(const std::uint64_t key, ItemDef& def) {
+    return loadEntry(key, Kind::Item, def);
+}
+
+bool AssetCache::load(const std::uint64_t key, AnimationSetDef& def) {
+    return loadEntry(key, Kind::AnimationSet, def);
+}
+
+bool AssetCache::load(const std::uint64_t key, PrefabDef& def) {
+    return loadEntry(key, Kind::Prefab, def);
+}
+
+void AssetCache::store(const std::uint64_t key, const sf::Image& img) {
+    std::vector<char> payload;
+    PayloadWriter w(payload);
+    const sf::Vector2u size = img.getSize();
+    w.write(static_cast<std::uint32_t>(size.x));
+    w.write(static_cast<std::uint32_t>(size.y));
+    w.write(img.getPixelsPtr(), static_cast<std::size_t>(size.x) * size.y * 4);
+
+    storeEntry(key, Kind::Image, payload);
+}
+
+void AssetCache::store(const std::uint64_t key, const TileDef& def) {
+    std::vector<char> payload;
+    PayloadWriter w(payload);
+    w.write(def.name);
+    w.write(def.texture);
+    w.write(static_cast<std::uint8_t>(def.collidable));
+
+    storeEntry(key, Kind::Tile, payload);
+}
+
+void AssetCache::store(const std::uint64_t key, const ItemDef& def) {
+    std::vector<char> payload;
+    PayloadWriter w(payload);
+    w.write(def.name);
+    w.write(def.texture);
+    w.write(def.placeTile);
+
+    storeEntry(key, Kind::Item, payload);
+}
+
+void AssetCache::store(const std::uint64_t key, const AnimationSetDef& def) {
+    std::vector<char> payload;
+    PayloadWriter w(payload);
+    w.write(def.name);
+    w.write(def.frameWidth);
+    w.write(def.frameHeight);
+    w.write(def.framerate);
+    w.write(static_cast<std::uint32_t>(def.clips.size()));
+    for (const AnimationClipDef& c : def.clips) {
+        w.write(c.name);
+        w.write(c.x);
+        w.write(c.y);
+        w.write(c.frames);
+        w.write(static_cast<std::uint8_t>(c.repeated));
+    }
+
+    storeEntry(key, Kind::AnimationSet, payload);
+}
+
+void AssetCache::store(const std::uint64_t key, const PrefabDef& def) {
+    std::vector<char> payload;
+    PayloadWriter w(payload);
+    w.write(def.name);
+    w.write(def.texture);
+    w.write(def.width);
+    w.write(def.height);
+    w.write(def.components);
+    w.write(def.clip);
+    w.write(def.boxX);
+    w.write(def.boxY);
+    w.write(def.boxWidth);
+    w.write(def.boxHeight);
+    w.write(def.inventorySize);
+    w.write(def.steeringSpeed);
+
+    storeEntry(key, Kind::Prefab, payload);
+}
+
+std::size_t AssetCache::getHits() const {
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+std::size_t AssetCache::getMisses() const {
+    return m_misses.load(std::memory_order_relaxed);
+}
+
+std::string AssetCache::getPath(const std::uint64_t key) const {
+    return fmt::format("{}/{:016x}.bin", m_dir, key);
+}
+
+template <typename T>
+bool AssetCache::loadEntry(const std::uint64_t key, const Kind kind,
+                           T& out) {
+    if (!m_enabled) {
+        return false;
+    }
+
+    MappedFile file;
+    bool hit = file.open(getPath(key));
+    if (hit) {
+        PayloadReader r(file.getData(), file.getSize());
+        EntryHeader h;
+        hit = r.read(h) && h.magic == MAGIC && h.version == VERSION &&
+              h.key == key && h.kind == kind &&
+              h.size == file.getSize() - sizeof(EntryHeader) &&
+              readPayload(r, out) && r.isDone();
+    }
+
+    (hit ? m_hits : m_misses).fetch_add(1, std::memory_order_relaxed);
+    return hit;
+}
+
+void AssetCache::storeEntry(const std::uint64_t key, const Kind kind,
+                            const std::vector<char>& payload) {
+    if (!m_enabled) {
+        return;
+    }
+
+    EntryHeader h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic   = MAGIC;
+    h.version = VERSION;
+    h.key     = key;
+    h.kind    = kind;
+    h.size    = static_cast<std::uint32_t>(payload.size());
+
+    // Written under a per-thread name and renamed, so readers never see a
+    // partial entry and identical files stored at once don't interleave
+    const std::string path = getPath(key);
+    const std::string tmp =
+        fmt::format("{}.{:x}.tmp", path,
+                    std::hash<std::thread::id>()(std::this_thread::get_id()));
+    bool written;
+    {
+        std::ofstream o(tmp, std::ios::binary | std::ios::trunc);
+        o.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        o.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        written = static_cast<bool>(o);
+    }
+
+    std::error_code ec;
+    if (written) {
+        fs::rename(tmp, path, ec);
+    }
+    if (!written || ec) {
+        spdlog::debug("Could not write asset cache entry {}", path);
+        fs::remove(tmp, ec);
+    }
+}
+
+}
@@ -0,0 +1,310 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AssetDefs.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+namespace {
+
+struct Field {
+    const char* name;
+    std::string* text; // Set for string fields
+    bool* flag; // Set for boolean fields
+    bool required;
+    bool seen;
+};
+
+// Fills the fields of a flat definition object, values nested deeper than
+// the top level object are skipped
+class DefinitionSax : public nlohmann::json_sax<nlohmann::json> {
+public:
+    DefinitionSax(Field* fields, const std::size_t fieldNo,
+                  const std::string& path)
+        : m_fields(fields), m_fieldNo(fieldNo), m_path(path),
+          m_current(nullptr), m_depth(0) {}
+
+    bool null() override {
+        return value("null");
+    }
+
+    bool boolean(const bool val) override {
+        if (!isTarget()) {
+            return true;
+        }
+
+        if (m_current->flag == nullptr) {
+            return typeError("a boolean");
+        }
+
+        *m_current->flag = val;
+        m_current->seen  = true;
+        return true;
+    }
+
+    bool number_integer(number_integer_t) override {
+        return value("a number");
+    }
+
+    bool number_unsigned(number_unsigned_t) override {
+        return value("a number");
+    }
+
+    bool number_float(number_float_t, const string_t&) override {
+        return value("a number");
+    }
+
+    bool string(string_t& val) override {
+        if (!isTarget()) {
+            return true;
+        }
+
+        if (m_current->text == nullptr) {
+            return typeError("a string");
+        }
+
+        // Assigned rather than moved, short names fit the small string buffer
+        m_current->text->assign(val);
+        m_current->seen = true;
+        return true;
+    }
+
+    bool binary(binary_t&) override {
+        return value("binary data");
+    }
+
+    bool start_object(std::size_t) override {
+        if (m_depth == 0) {
+            m_depth++;
+            return true;
+        }
+
+        return nest("an object");
+    }
+
+    bool key(string_t& val) override {
+        m_current = nullptr;
+        if (m_depth != 1) {
+            return true;
+        }
+
+        for (std::size_t i = 0; i < m_fieldNo; i++) {
+            if (val == m_fields[i].name) {
+                m_current = &m_fields[i];
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        m_depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (m_depth == 0) {
+            spdlog::warn("Could not parse file {}: expected an object", m_path);
+            return false;
+        }
+
+        return nest("an array");
+    }
+
+    bool end_array() override {
+        m_depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& e) override {
+        spdlog::warn("Could not parse file {}: {}", m_path, e.what());
+        return false;
+    }
+
+    bool finish() const {
+        for (std::size_t i = 0; i < m_fieldNo; i++) {
+            if (m_fields[i].required && !m_fields[i].seen) {
+                spdlog::warn("Invalid asset {}: missing field \"{}\"", m_path,
+                             m_fields[i].name);
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool isTarget() const {
+        return m_depth == 1 && m_current != nullptr;
+    }
+
+    bool value(const char* type) {
+        if (m_depth == 0) {
+            spdlog::warn("Could not parse file {}: expected an object", m_path);
+            return false;
+        }
+
+        return isTarget() ? typeError(type) : true;
+    }
+
+    bool nest(const char* type) {
+        if (isTarget()) {
+            return typeError(type);
+        }
+
+        m_depth++;
+        return true;
+    }
+
+    bool typeError(const char* got) {
+        spdlog::warn("Invalid asset {}: field \"{}\" can't be {}", m_path,
+                     m_current->name, got);
+        return false;
+    }
+
+private:
+    Field* m_fields;
+    std::size_t m_fieldNo;
+    const std::string& m_path;
+    Field* m_current; // Field the last top level key names
+    unsigned int m_depth;
+};
+
+template <std::size_t N>
+bool parse(const char* data, const std::size_t size, const std::string& path,
+           Field (&fields)[N]) {
+    DefinitionSax sax(fields, N, path);
+    return nlohmann::json::sax_parse(data, data + size, &sax) && sax.finish();
+}
+
+}
+
+namespace nc {
+
+bool parseTileDef(const char* data, const std::size_t size,
+                  const std::string& path, TileDef& def) {
+    Field fields[] = {{"name", &def.name, nullptr, true, false},
+                      {"texture", &def.texture, nullptr, true, false},
+                      {"collidable", nullptr, &def.collidable, false, false}};
+    return parse(data, size, path, fields);
+}
+
+bool parseItemDef(const char* data, const std::size_t size,
+                  const std::string& path, ItemDef& def) {
+    Field fields[] = {{"name", &def.name, nullptr, true, false},
+                      {"texture", &def.texture, nullptr, true, false},
+                      {"placeTile", &def.placeTile, nullptr, false, false}};
+    return parse(data, size, path, fields);
+}
+
+bool parseAnimationSetDef(const char* data, const std::size_t size,
+                          const std::string& path, AnimationSetDef& def) {
+    const nlohmann::json j =
+        nlohmann::json::parse(data, data + size, nullptr, false);
+    if (j.is_discarded()) {
+        spdlog::warn("Could not parse file {}!", path);
+        return false;
+    }
+
+    try {
+        def.name        = j.at("name").get<std::string>();
+        def.frameWidth  = j.value("frameWidth", def.frameWidth);
+        def.frameHeight = j.value("frameHeight", def.frameHeight);
+        def.framerate   = j.value("framerate", def.framerate);
+
+        for (const nlohmann::json& c : j.at("clips")) {
+            AnimationClipDef clip;
+            clip.name     = c.at("name").get<std::string>();
+            clip.x        = c.value("x", clip.x);
+            clip.y        = c.value("y", clip.y);
+            clip.frames   = c.value("frames", clip.frames);
+            clip.repeated = c.value("repeated", clip.repeated);
+            if (clip.frames == 0) {
+                spdlog::warn("Invalid asset {}: clip {} has no frames", path,
+                             clip.name);
+                return false;
+            }
+            def.clips.push_back(std::move(clip));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::warn("Invalid asset {}: {}", path, e.what());
+        return false;
+    }
+
+    if (def.framerate <= 0.0f || def.frameWidth <= 0 || def.frameHeight <= 0) {
+        spdlog::warn("Invalid asset {}: frame size and rate must be positive",
+                     path);
+        return false;
+    }
+
+    return true;
+}
+
+bool parsePrefabDef(const char* data, const std::size_t size,
+                    const std::string& path, PrefabDef& def) {
+    const nlohmann::json j =
+        nlohmann::json::parse(data, data + size, nullptr, false);
+    if (j.is_discarded()) {
+        spdlog::warn("Could not parse file {}!", path);
+        return false;
+    }
+
+    try {
+        def.name    = j.at("name").get<std::string>();
+        def.texture = j.at("texture").get<std::string>();
+        def.width   = j.value("width", def.width);
+        def.height  = j.value("height", def.height);
+
+        const nlohmann::json components =
+            j.value("components", nlohmann::json::object());
+        for (const auto& [type, c] : components.items()) {
+            if (type == "velocity") {
+                def.components |= PrefabDef::Velocity;
+            } else if (type == "collisionBox") {
+                def.components |= PrefabDef::CollisionBox;
+                def.boxX      = c.value("x", def.boxX);
+                def.boxY      = c.value("y", def.boxY);
+                def.boxWidth  = c.value("width", def.boxWidth);
+                def.boxHeight = c.value("height", def.boxHeight);
+            } else if (type == "animation") {
+                def.components |= PrefabDef::Animation;
+                def.clip = c.at("clip").get<std::string>();
+            } else if (type == "inventory") {
+                def.components |= PrefabDef::Inventory;
+                def.inventorySize = c.at("size").get<unsigned int>();
+            } else if (type == "player") {
+                def.components |= PrefabDef::Player;
+            } else if (type == "steering") {
+                def.components |= PrefabDef::Steering;
+                def.steeringSpeed = c.value("speed", def.steeringSpeed);
+            } else {
+                spdlog::warn("Invalid asset {}: unknown component {}", path,
+                             type);
+                return false;
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::warn("Invalid asset {}: {}", path, e.what());
+        return false;
+    }
+
+    if (def.width == 0 || def.height == 0) {
+        spdlog::warn("Invalid asset {}: size must be positive", path);
+        return false;
+    }
+
+    return true;
+}
+
+}
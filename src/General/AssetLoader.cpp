@@ -0,0 +1,463 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AssetLoader.hpp>
+#include <General/Profiler.hpp>
+#include <General/FileReader.hpp>
+#include <General/Metrics.hpp>
+#include <Game/Game.hpp>
+#include <Game/Item.hpp>
+#include <Game/Prefab.hpp>
+#include <World/Tile.hpp>
+#include <physfs.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::vector<std::string> listFiles(const char* dir) {
+    std::vector<std::string> files;
+    char** list = PHYSFS_enumerateFiles(dir);
+    if (list == nullptr) {
+        return files;
+    }
+
+    for (char** f = list; *f != nullptr; f++) {
+        files.push_back(std::string(dir) + '/' + *f);
+    }
+    PHYSFS_freeList(list);
+
+    // Same registration order on every platform
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void registerTile(const std::string& name, const std::string& texture,
+                  const bool collidable) {
+    nc::Tile* t = new nc::Tile;
+    t->setName(name);
+    t->setTexture(texture);
+    t->setCollidable(collidable);
+
+    nc::Game::getInstance()->getRegistry().registerTile(t);
+}
+
+void registerItem(const std::string& name, const std::string& texture,
+                  const char* placeTile) {
+    nc::Item* i = new nc::Item;
+    i->setName(name);
+    i->setTexture(texture);
+    if (placeTile != nullptr) {
+        i->setPlaceableTile(placeTile);
+    }
+
+    nc::Game::getInstance()->getRegistry().registerItem(i);
+}
+
+void registerDef(const nc::TileDef& def) {
+    registerTile(def.name, def.texture, def.collidable);
+}
+
+void registerClip(const std::string& name, const int x, const int y,
+                  const int frameWidth, const int frameHeight,
+                  const unsigned int frames, const float frameTime,
+                  const bool repeated) {
+    nc::AnimationClip clip;
+    clip.firstFrame = sf::Vector2i(x, y);
+    clip.frameSize  = sf::Vector2i(frameWidth, frameHeight);
+    clip.frames     = frames;
+    clip.frameTime  = frameTime;
+    clip.repeated   = repeated;
+
+    nc::Game::getInstance()->getAnimations().add(name, clip);
+}
+
+void registerDef(const nc::AnimationSetDef& def) {
+    for (const nc::AnimationClipDef& c : def.clips) {
+        registerClip(def.name + '.' + c.name, c.x, c.y, def.frameWidth,
+                     def.frameHeight, c.frames, 1.0f / def.framerate,
+                     c.repeated);
+    }
+}
+
+void registerDef(const nc::ItemDef& def) {
+    registerItem(def.name, def.texture,
+                 def.placeTile.empty() ? nullptr : def.placeTile.c_str());
+}
+
+// Compiled against the loaded textures and clips, so prefabs come last
+void registerDef(const nc::PrefabDef& def) {
+    nc::GameRegistry& reg = nc::Game::getInstance()->getRegistry();
+    if (nc::Prefab* p = reg.getPrefab(def.name); p != nullptr) {
+        *p = nc::Prefab(def);
+    } else {
+        reg.registerPrefab(new nc::Prefab(def));
+    }
+}
+
+// Reads the file and takes its product from the cache if the contents are
+// unchanged, decoding and storing it otherwise
+template <typename Product, typename Decode>
+bool loadCached(const std::string& path, nc::AssetCache* cache,
+                Product& out, Decode decode) {
+    nc::FileReader& reader = nc::FileReader::getLocal();
+    if (!reader.read(path)) {
+        return false;
+    }
+
+    if (cache == nullptr) {
+        return decode(reader.getData(), reader.getSize(), out);
+    }
+
+    const std::uint64_t key =
+        nc::AssetCache::getKey(path, reader.getData(), reader.getSize());
+    if (cache->load(key, out)) {
+        return true;
+    }
+
+    if (!decode(reader.getData(), reader.getSize(), out)) {
+        return false;
+    }
+
+    cache->store(key, out);
+    return true;
+}
+
+template <typename Def>
+bool readDef(const std::string& path,
+             bool (*parse)(const char*, std::size_t, const std::string&,
+                           Def&),
+             Def& def, nc::AssetCache* cache = nullptr) {
+    return loadCached(path, cache, def,
+                      [&](const char* data, std::size_t size, Def& d) {
+                          return parse(data, size, path, d);
+                      });
+}
+
+template <typename T>
+bool isReady(const std::future<T>& f) {
+    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+}
+
+namespace nc {
+
+AssetLoader::AssetLoader(ThreadPool& pool, const bool loadTextures,
+                         const std::string& cacheDir)
+    : m_pool(pool),
+      m_cache(cacheDir.empty() ? nullptr
+                               : std::make_shared<AssetCache>(cacheDir)),
+      m_texturesDone(0), m_tilesDone(0), m_itemsDone(0), m_animationsDone(0),
+      m_prefabsDone(0),
+#ifdef NC_TRACK_ALLOCATIONS
+      m_allocations(Metrics::getCounter("memory.allocations").get()),
+#endif
+      m_reported(false) {
+    if (loadTextures) {
+        const std::vector<std::string> files = listFiles("/textures");
+        m_textures.reserve(files.size());
+        for (const std::string& path : files) {
+            m_textures.push_back(m_pool.submit([path, cache = m_cache]() {
+                NC_PROFILE_SCOPE("Decode texture");
+                DecodedImage d;
+                d.path = path;
+                const auto decode = [](const char* data, std::size_t size,
+                                       sf::Image& img) {
+                    return img.loadFromMemory(data, size);
+                };
+                if (!loadCached(path, cache.get(), d.image, decode) &&
+                    !TextureAtlas::decodeImage(path, d.image)) {
+                    spdlog::error("Could not load texture {}", path);
+                }
+                return d;
+            }));
+        }
+    }
+
+    queueDefs("/tiles", &parseTileDef, m_tiles);
+    queueDefs("/items", &parseItemDef, m_items);
+    queueDefs("/animations", &parseAnimationSetDef, m_animations);
+    queueDefs("/prefabs", &parsePrefabDef, m_prefabs);
+}
+
+bool AssetLoader::update(const float budget) {
+    NC_PROFILE_FUNCTION();
+    sf::Clock clock;
+    const auto overBudget = [&]() {
+        return clock.getElapsedTime().asSeconds() >= budget;
+    };
+
+    // Upload textures in whatever order they finish decoding
+    TextureAtlas& atlas = Game::getInstance()->getTextureAtlas();
+    for (std::size_t i = 0; i < m_textures.size() && !overBudget();) {
+        if (!isReady(m_textures[i])) {
+            i++;
+            continue;
+        }
+
+        const DecodedImage d = m_textures[i].get();
+        atlas.addTexture(d.path, d.image);
+        m_texturesDone++;
+
+        m_textures[i] = std::move(m_textures.back());
+        m_textures.pop_back();
+    }
+
+    // Definitions look their textures up when registered
+    if (!m_textures.empty()) {
+        return false;
+    }
+
+    const auto apply = [&](auto& jobs, std::size_t& done) {
+        while (done < jobs.size() && !overBudget() && isReady(jobs[done])) {
+            const auto d = jobs[done].get();
+            if (d.valid) {
+                registerDef(d.def);
+            }
+            done++;
+        }
+        return done == jobs.size();
+    };
+
+    if (!apply(m_tiles, m_tilesDone) || !apply(m_items, m_itemsDone) ||
+        !apply(m_animations, m_animationsDone) ||
+        !apply(m_prefabs, m_prefabsDone)) {
+        return false;
+    }
+
+    if (!m_reported) {
+        const float seconds = m_clock.getElapsedTime().asSeconds();
+        spdlog::info("Loaded {} textures, {} tiles, {} items, {} "
+                     "animation sets and {} prefabs in {:.3f} s on {} "
+                     "threads",
+                     m_texturesDone, m_tilesDone, m_itemsDone,
+                     m_animationsDone, m_prefabsDone, seconds,
+                     m_pool.getThreadNo());
+#ifdef NC_TRACK_ALLOCATIONS
+        spdlog::info("Loading made {} allocations",
+                     Metrics::getCounter("memory.allocations").get() -
+                         m_allocations);
+#endif
+
+        if (m_cache != nullptr) {
+            // Fully cached and fully decoded loads are timed apart, so a
+            // regression in either shows up
+            const std::size_t hits   = m_cache->getHits();
+            const std::size_t misses = m_cache->getMisses();
+            const char* start = misses == 0 ? "warm" : hits == 0 ? "cold"
+                                                                 : "partial";
+            spdlog::info("Asset cache: {} start, {} hits, {} misses", start,
+                         hits, misses);
+            if (misses == 0) {
+                Metrics::getHistogram("assets.load_time_warm").record(seconds);
+            } else if (hits == 0) {
+                Metrics::getHistogram("assets.load_time_cold").record(seconds);
+            }
+        }
+        m_reported = true;
+    }
+
+    return true;
+}
+
+void AssetLoader::loadPack(const AssetPack& pack, const bool loadTextures) {
+    NC_PROFILE_FUNCTION();
+    sf::Clock clock;
+
+    if (loadTextures) {
+        TextureAtlas& atlas = Game::getInstance()->getTextureAtlas();
+        for (std::uint32_t i = 0; i < pack.getTextureNo(); i++) {
+            const PackTexture& t = pack.getTexture(i);
+            atlas.addTexture(pack.getString(t.name), pack.getPixels(t),
+                             t.width, t.height);
+        }
+    }
+
+    for (std::uint32_t i = 0; i < pack.getTileNo(); i++) {
+        const PackTile& t = pack.getTile(i);
+        registerTile(pack.getString(t.name), pack.getString(t.texture),
+                     t.collidable != 0);
+    }
+
+    for (std::uint32_t i = 0; i < pack.getItemNo(); i++) {
+        const PackItem& it = pack.getItem(i);
+        registerItem(pack.getString(it.name), pack.getString(it.texture),
+                     pack.getString(it.placeTile));
+    }
+
+    for (std::uint32_t i = 0; i < pack.getClipNo(); i++) {
+        const PackClip& c = pack.getClip(i);
+        registerClip(pack.getString(c.name), c.x, c.y,
+                     static_cast<int>(c.frameWidth),
+                     static_cast<int>(c.frameHeight), c.frames, c.frameTime,
+                     c.repeated != 0);
+    }
+
+    for (std::uint32_t i = 0; i < pack.getPrefabNo(); i++) {
+        const PackPrefab& p = pack.getPrefab(i);
+        PrefabDef def;
+        def.name          = pack.getString(p.name);
+        def.texture       = pack.getString(p.texture);
+        def.width         = p.width;
+        def.height        = p.height;
+        def.components    = p.components;
+        def.clip          = p.clip == AssetPack::NO_STRING
+                                ? std::string()
+                                : pack.getString(p.clip);
+        def.boxX          = p.boxX;
+        def.boxY          = p.boxY;
+        def.boxWidth      = p.boxWidth;
+        def.boxHeight     = p.boxHeight;
+        def.inventorySize = p.inventorySize;
+        def.steeringSpeed = p.steeringSpeed;
+        registerDef(def);
+    }
+
+    spdlog::info("Loaded {} textures, {} tiles, {} items, {} animation clips "
+                 "and {} prefabs from the asset pack in {:.3f} s",
+                 loadTextures ? pack.getTextureNo() : 0, pack.getTileNo(),
+                 pack.getItemNo(), pack.getClipNo(), pack.getPrefabNo(),
+                 clock.getElapsedTime().asSeconds());
+}
+
+bool AssetLoader::reload(const std::string& path) {
+    NC_PROFILE_FUNCTION();
+    Game* game       = Game::getInstance();
+    GameState* state = game->getState();
+
+    if (path.rfind("/textures/", 0) == 0) {
+        sf::Image img;
+        if (!TextureAtlas::decodeImage(path, img)) {
+            return false;
+        }
+
+        // Replaces the texture without moving it, sprites keep pointing to it
+        TextureAtlas& atlas = game->getTextureAtlas();
+        atlas.addTexture(path, img);
+        if (state != nullptr) {
+            state->onTextureReloaded(atlas.getTexture(path.substr(10)));
+        }
+        return true;
+    }
+
+    GameRegistry& reg = game->getRegistry();
+    if (path.rfind("/tiles/", 0) == 0) {
+        TileDef def;
+        if (!readDef(path, &parseTileDef, def)) {
+            return false;
+        }
+
+        Tile* t = reg.getTile(def.name);
+        if (t == nullptr) {
+            registerDef(def);
+            t = reg.getTile(def.name);
+        } else {
+            t->setTexture(def.texture);
+            t->setCollidable(def.collidable);
+        }
+
+        if (state != nullptr) {
+            state->onTileReloaded(t);
+        }
+        return true;
+    }
+
+    if (path.rfind("/items/", 0) == 0) {
+        ItemDef def;
+        if (!readDef(path, &parseItemDef, def)) {
+            return false;
+        }
+
+        Item* i = reg.getItem(def.name);
+        if (i == nullptr) {
+            registerDef(def);
+        } else {
+            i->setTexture(def.texture);
+            i->setPlaceableTile(def.placeTile.empty() ? "null"
+                                                      : def.placeTile);
+        }
+        return true;
+    }
+
+    if (path.rfind("/animations/", 0) == 0) {
+        AnimationSetDef def;
+        if (!readDef(path, &parseAnimationSetDef, def)) {
+            return false;
+        }
+
+        // Clips keep their ids, playing animations pick the change up on
+        // their next frame
+        registerDef(def);
+        return true;
+    }
+
+    if (path.rfind("/prefabs/", 0) == 0) {
+        PrefabDef def;
+        if (!readDef(path, &parsePrefabDef, def)) {
+            return false;
+        }
+
+        // Only entities spawned from now on use the new recipe
+        registerDef(def);
+        return true;
+    }
+
+    return false;
+}
+
+void AssetLoader::finish() {
+    while (!update(1.0f)) {
+        std::this_thread::yield();
+    }
+}
+
+float AssetLoader::getProgress() const {
+    const std::size_t total = m_texturesDone + m_textures.size() +
+                              m_tiles.size() + m_items.size() +
+                              m_animations.size() + m_prefabs.size();
+    if (total == 0) {
+        return 1.0f;
+    }
+
+    return static_cast<float>(m_texturesDone + m_tilesDone + m_itemsDone +
+                              m_animationsDone + m_prefabsDone) /
+           static_cast<float>(total);
+}
+
+bool AssetLoader::isDone() const {
+    return m_textures.empty() && m_tilesDone == m_tiles.size() &&
+           m_itemsDone == m_items.size() &&
+           m_animationsDone == m_animations.size() &&
+           m_prefabsDone == m_prefabs.size();
+}
+
+template <typename Def>
+void AssetLoader::queueDefs(const char* dir, const DefParser<Def> parse,
+                            std::vector<std::future<DecodedDef<Def>>>& out) {
+    const std::vector<std::string> files = listFiles(dir);
+    out.reserve(files.size());
+    for (const std::string& path : files) {
+        out.push_back(m_pool.submit([path, parse, cache = m_cache]() {
+            NC_PROFILE_SCOPE("Parse definition");
+            DecodedDef<Def> d;
+            d.valid = readDef(path, parse, d.def, cache.get());
+            return d;
+        }));
+    }
+}
+
+}
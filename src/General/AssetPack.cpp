@@ -0,0 +1,181 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AssetPack.hpp>
+#include <spdlog/spdlog.h>
+
+namespace nc {
+
+AssetPack::AssetPack()
+    : m_header(nullptr), m_textures(nullptr), m_tiles(nullptr),
+      m_items(nullptr), m_clips(nullptr), m_prefabs(nullptr),
+      m_strings(nullptr) {}
+
+bool AssetPack::open(const std::string& path) {
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const unsigned char* base = m_file.getData();
+    if (m_file.getSize() < sizeof(PackHeader)) {
+        spdlog::error("Asset pack {} is truncated!", path);
+        m_file.close();
+        return false;
+    }
+
+    // Fix up the table pointers, everything else is used in place
+    m_header   = reinterpret_cast<const PackHeader*>(base);
+    m_textures = reinterpret_cast<const PackTexture*>(base +
+                                                      m_header->textureOffset);
+    m_tiles    = reinterpret_cast<const PackTile*>(base + m_header->tileOffset);
+    m_items    = reinterpret_cast<const PackItem*>(base + m_header->itemOffset);
+    m_clips    = reinterpret_cast<const PackClip*>(base + m_header->clipOffset);
+    m_prefabs  = reinterpret_cast<const PackPrefab*>(base +
+                                                     m_header->prefabOffset);
+    m_strings  = reinterpret_cast<const char*>(base + m_header->stringOffset);
+
+    if (!validate()) {
+        spdlog::error("Asset pack {} is invalid or from another version!",
+                      path);
+        m_file.close();
+        m_header = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+std::uint32_t AssetPack::getTextureNo() const {
+    return m_header->textureNo;
+}
+
+const PackTexture& AssetPack::getTexture(const std::uint32_t i) const {
+    return m_textures[i];
+}
+
+const unsigned char* AssetPack::getPixels(const PackTexture& texture) const {
+    return m_file.getData() + texture.pixels;
+}
+
+std::uint32_t AssetPack::getTileNo() const {
+    return m_header->tileNo;
+}
+
+const PackTile& AssetPack::getTile(const std::uint32_t i) const {
+    return m_tiles[i];
+}
+
+std::uint32_t AssetPack::getItemNo() const {
+    return m_header->itemNo;
+}
+
+const PackItem& AssetPack::getItem(const std::uint32_t i) const {
+    return m_items[i];
+}
+
+std::uint32_t AssetPack::getClipNo() const {
+    return m_header->clipNo;
+}
+
+const PackClip& AssetPack::getClip(const std::uint32_t i) const {
+    return m_clips[i];
+}
+
+std::uint32_t AssetPack::getPrefabNo() const {
+    return m_header->prefabNo;
+}
+
+const PackPrefab& AssetPack::getPrefab(const std::uint32_t i) const {
+    return m_prefabs[i];
+}
+
+const char* AssetPack::getString(const std::uint32_t offset) const {
+    return offset == NO_STRING ? nullptr : m_strings + offset;
+}
+
+bool AssetPack::validate() const {
+    const std::uint64_t size = m_file.getSize();
+    const PackHeader& h      = *m_header;
+
+    const auto fits = [size](const std::uint64_t offset,
+                             const std::uint64_t bytes) {
+        return offset <= size && bytes <= size - offset;
+    };
+    const auto aligned = [](const std::uint64_t offset) {
+        return offset % ALIGNMENT == 0;
+    };
+
+    if (h.magic != MAGIC || h.version != VERSION ||
+        !aligned(h.textureOffset) || !aligned(h.tileOffset) ||
+        !aligned(h.itemOffset) || !aligned(h.clipOffset) ||
+        !aligned(h.prefabOffset) ||
+        !fits(h.textureOffset,
+              static_cast<std::uint64_t>(h.textureNo) * sizeof(PackTexture)) ||
+        !fits(h.tileOffset,
+              static_cast<std::uint64_t>(h.tileNo) * sizeof(PackTile)) ||
+        !fits(h.itemOffset,
+              static_cast<std::uint64_t>(h.itemNo) * sizeof(PackItem)) ||
+        !fits(h.clipOffset,
+              static_cast<std::uint64_t>(h.clipNo) * sizeof(PackClip)) ||
+        !fits(h.prefabOffset,
+              static_cast<std::uint64_t>(h.prefabNo) * sizeof(PackPrefab)) ||
+        !fits(h.stringOffset, h.stringSize) || h.stringSize == 0 ||
+        m_strings[h.stringSize - 1] != '\0') {
+        return false;
+    }
+
+    const auto validString = [&h](const std::uint32_t s, const bool optional) {
+        return (optional && s == NO_STRING) || s < h.stringSize;
+    };
+
+    for (std::uint32_t i = 0; i < h.textureNo; i++) {
+        const PackTexture& t = m_textures[i];
+        const std::uint64_t size =
+            static_cast<std::uint64_t>(t.width) * t.height * 4;
+        if (!validString(t.name, false) || !fits(t.pixels, size)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < h.tileNo; i++) {
+        if (!validString(m_tiles[i].name, false) ||
+            !validString(m_tiles[i].texture, false)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < h.itemNo; i++) {
+        if (!validString(m_items[i].name, false) ||
+            !validString(m_items[i].texture, false) ||
+            !validString(m_items[i].placeTile, true)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < h.clipNo; i++) {
+        // Playback steps through frames until their time is used up
+        if (!validString(m_clips[i].name, false) || m_clips[i].frames == 0 ||
+            !(m_clips[i].frameTime > 0.0f)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < h.prefabNo; i++) {
+        const PackPrefab& p = m_prefabs[i];
+        if (!validString(p.name, false) || !validString(p.texture, false) ||
+            !validString(p.clip, true) || p.width == 0 || p.height == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
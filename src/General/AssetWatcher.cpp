@@ -0,0 +1,106 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/AssetWatcher.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace {
+    constexpr const char* WATCHED_DIRS[] = {"/textures", "/tiles", "/items",
+                                            "/animations", "/prefabs"};
+}
+
+namespace nc {
+
+#ifdef __linux__
+
+AssetWatcher::AssetWatcher(const std::string& root)
+    : m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+    if (m_fd == -1) {
+        spdlog::warn("Could not watch assets: {}", std::strerror(errno));
+        return;
+    }
+
+    for (const char* dir : WATCHED_DIRS) {
+        // Editors often save by renaming a temporary file over the original
+        const int wd = inotify_add_watch(m_fd, (root + dir).c_str(),
+                                         IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd != -1) {
+            m_dirs[wd] = dir;
+        }
+    }
+
+    spdlog::info("Watching {} for asset changes", root);
+}
+
+AssetWatcher::~AssetWatcher() {
+    if (m_fd != -1) {
+        close(m_fd);
+    }
+}
+
+std::vector<std::string> AssetWatcher::poll() {
+    std::vector<std::string> changed;
+    if (m_fd == -1) {
+        return changed;
+    }
+
+    alignas(inotify_event) char buf[4096];
+    while (true) {
+        const ssize_t len = read(m_fd, buf, sizeof(buf));
+        if (len <= 0) {
+            break;
+        }
+
+        for (ssize_t i = 0; i < len;) {
+            const auto* e = reinterpret_cast<const inotify_event*>(buf + i);
+            const auto dir = m_dirs.find(e->wd);
+            const std::string name = e->len > 0 ? e->name : "";
+            // Skip the temporary and backup files editors write
+            if (!name.empty() && name[0] != '.' && name.back() != '~' &&
+                dir != m_dirs.end()) {
+                changed.push_back(dir->second + '/' + name);
+            }
+            i += static_cast<ssize_t>(sizeof(inotify_event) + e->len);
+        }
+    }
+
+    // A single save can produce several events
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return changed;
+}
+
+#else
+
+AssetWatcher::AssetWatcher(const std::string& root) : m_fd(-1) {
+    spdlog::warn("Asset hot reload is only supported on Linux");
+}
+
+AssetWatcher::~AssetWatcher() {}
+
+std::vector<std::string> AssetWatcher::poll() {
+    return {};
+}
+
+#endif
+
+}
@@ -0,0 +1,69 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/FileReader.hpp>
+#include <physfs.h>
+#include <spdlog/spdlog.h>
+
+namespace nc {
+
+FileReader& FileReader::getLocal() {
+    thread_local FileReader reader;
+    return reader;
+}
+
+FileReader::FileReader() : m_size(0) {}
+
+bool FileReader::read(const std::string& path) {
+    m_size = 0;
+
+    PHYSFS_File* fileHandle = PHYSFS_openRead(path.c_str());
+    if (fileHandle == NULL) {
+        spdlog::warn("Could not open file {}!", path);
+        return false;
+    }
+
+    const PHYSFS_sint64 fileSize = PHYSFS_fileLength(fileHandle);
+    if (fileSize == -1) {
+        spdlog::warn("Could not retreive size for file {}!", path);
+        PHYSFS_close(fileHandle);
+        return false;
+    }
+
+    const auto size = static_cast<std::size_t>(fileSize);
+    if (size > m_buffer.size()) {
+        m_buffer.resize(size);
+    }
+
+    const PHYSFS_sint64 read =
+        PHYSFS_readBytes(fileHandle, m_buffer.data(), fileSize);
+    PHYSFS_close(fileHandle);
+    if (read < fileSize) {
+        spdlog::warn("Could not read file {}!", path);
+        return false;
+    }
+
+    m_size = size;
+    return true;
+}
+
+const char* FileReader::getData() const {
+    return m_buffer.data();
+}
+
+std::size_t FileReader::getSize() const {
+    return m_size;
+}
+
+}
@@ -0,0 +1,139 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/FramePacer.hpp>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+namespace nc {
+
+FramePacer::FramePacer()
+    : m_period(Clock::duration::zero()), m_nextFrame(Clock::now()),
+      m_lastFrame(m_nextFrame), m_spinMargin(MIN_SPIN), m_samples(),
+      m_sampleCount(0), m_nextSample(0) {}
+
+void FramePacer::setTargetFramerate(const float fps) {
+    Clock::duration period = Clock::duration::zero();
+    if (fps > 0.0f) {
+        period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(1.0f / fps));
+    }
+
+    if (period != m_period) {
+        m_period    = period;
+        m_nextFrame = m_lastFrame;
+    }
+}
+
+float FramePacer::getTargetFramerate() const {
+    if (m_period == Clock::duration::zero()) {
+        return 0.0f;
+    }
+
+    return 1.0f / std::chrono::duration<float>(m_period).count();
+}
+
+void FramePacer::wait() {
+    if (m_period == Clock::duration::zero()) {
+        recordFrame(Clock::now());
+        return;
+    }
+
+    m_nextFrame += m_period;
+    Clock::time_point now = Clock::now();
+
+    if (m_nextFrame + m_period < now) {
+        // Too far behind (stall or long frame), restart the schedule
+        // instead of releasing a burst of frames to catch up
+        m_nextFrame = now;
+    } else if (now < m_nextFrame) {
+        // Sleep for the bulk of the wait, then spin the remainder since the
+        // scheduler can wake us up late by up to a timer slice
+        const Clock::time_point wakeUp = m_nextFrame - m_spinMargin;
+        if (now < wakeUp) {
+            std::this_thread::sleep_until(wakeUp);
+            const Clock::duration overshoot = Clock::now() - wakeUp;
+
+            // Track the observed oversleep, decaying slowly towards the
+            // minimum margin when the scheduler is behaving
+            if (overshoot > m_spinMargin) {
+                m_spinMargin = std::min<Clock::duration>(overshoot, MAX_SPIN);
+            } else {
+                m_spinMargin = std::max<Clock::duration>(
+                    m_spinMargin - m_spinMargin / 16, MIN_SPIN);
+            }
+        }
+
+        while (Clock::now() < m_nextFrame) {
+            std::this_thread::yield();
+        }
+
+        now = Clock::now();
+    }
+
+    recordFrame(now);
+}
+
+float FramePacer::getFrameTime() const {
+    if (m_sampleCount == 0) {
+        return 0.0f;
+    }
+
+    float sum = 0.0f;
+    for (unsigned int i = 0; i < m_sampleCount; i++) {
+        sum += m_samples[i];
+    }
+
+    return sum / static_cast<float>(m_sampleCount);
+}
+
+float FramePacer::getJitter() const {
+    if (m_sampleCount == 0) {
+        return 0.0f;
+    }
+
+    // Deviation from the target when capped, from the average otherwise
+    const float expected = m_period == Clock::duration::zero()
+                               ? getFrameTime()
+                               : 1.0f / getTargetFramerate();
+    float sum            = 0.0f;
+    for (unsigned int i = 0; i < m_sampleCount; i++) {
+        sum += std::fabs(m_samples[i] - expected);
+    }
+
+    return sum / static_cast<float>(m_sampleCount);
+}
+
+float FramePacer::getMaxJitter() const {
+    const float expected = m_period == Clock::duration::zero()
+                               ? getFrameTime()
+                               : 1.0f / getTargetFramerate();
+    float maxJitter      = 0.0f;
+    for (unsigned int i = 0; i < m_sampleCount; i++) {
+        maxJitter = std::max(maxJitter, std::fabs(m_samples[i] - expected));
+    }
+
+    return maxJitter;
+}
+
+void FramePacer::recordFrame(const Clock::time_point now) {
+    m_samples[m_nextSample] =
+        std::chrono::duration<float>(now - m_lastFrame).count();
+    m_nextSample  = (m_nextSample + 1) % SAMPLE_NO;
+    m_sampleCount = std::min(m_sampleCount + 1, SAMPLE_NO);
+    m_lastFrame   = now;
+}
+
+}
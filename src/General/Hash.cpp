@@ -0,0 +1,35 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/Hash.hpp>
+
+namespace nc {
+
+void Hash::add(const void* data, const std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        m_value ^= bytes[i];
+        m_value *= PRIME;
+    }
+}
+
+void Hash::add(const std::string& str) {
+    add(str.data(), str.size());
+}
+
+std::uint64_t Hash::get() const {
+    return m_value;
+}
+
+}
@@ -17,101 +17,147 @@
 #include <Components/PlayerInputComponent.hpp>
 #include <Components/VelocityComponent.hpp>
 #include <Components/AnimationComponent.hpp>
+#include <General/AnimationSystem.hpp>
 
 namespace {
     static constexpr float PLAYER_VEL = 2.5f;
     static constexpr float SHIFT_FACTOR = 5.0f;
     static constexpr float CTRL_FACTOR = 0.2f;
 
-    sf::Keyboard::Key getKey(const char* key, const nlohmann::json& sett) {
-        return sett["controls"][key].get<sf::Keyboard::Key>();
+    struct WalkClips {
+        nc::ClipId idle;
+        nc::ClipId up;
+        nc::ClipId down;
+        nc::ClipId left;
+        nc::ClipId right;
+    };
+
+    // Clips are never removed from the library, so the ids stay valid
+    const WalkClips& getWalkClips() {
+        static const WalkClips clips = [] {
+            const nc::AnimationLibrary& lib =
+                nc::Game::getInstance()->getAnimations();
+            return WalkClips{lib.getId("player.idle"),
+                             lib.getId("player.walk_up"),
+                             lib.getId("player.walk_down"),
+                             lib.getId("player.walk_left"),
+                             lib.getId("player.walk_right")};
+        }();
+        return clips;
     }
 }
 
 namespace nc {
 
 void InputHandler::handleInput(const sf::Event& e, entt::registry& reg) {
-    
-}
-
-void InputHandler::pollInput(entt::registry& reg) {
-    const nlohmann::json& sett = Game::getInstance()->getSettings();
+    if (e.type == sf::Event::LostFocus) {
+        // Key releases are not delivered to an unfocused window
+        reg.view<PlayerInputComponent>().each([](auto& in) {
+            in.released |= in.held;
+            in.held.reset();
+        });
+        return;
+    }
 
-    float factor = 1.0f;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) {
-        factor = SHIFT_FACTOR;
-    } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl)) {
-        factor = CTRL_FACTOR;
+    if (e.type != sf::Event::KeyPressed && e.type != sf::Event::KeyReleased) {
+        return;
     }
 
-    reg.view<PlayerInputComponent, VelocityComponent>().each([&](auto p, auto& vel) {
-        AnimationComponent* ac = reg.try_get<AnimationComponent>(p);
-        bool movingUp = false;
-        bool movingDown = false;
-        bool movingLeft = false;
-        bool movingRight = false;
-        std::string currentAnim;
-
-        if (sf::Keyboard::isKeyPressed(getKey("move_up", sett))) {
-            vel.velocity.y = -PLAYER_VEL * factor;
-            movingUp = true;
-            movingDown = false;
-        }
+    const Action action =
+        Game::getInstance()->getActionMap().getAction(e.key.code);
+    if (action == Action::None) {
+        return;
+    }
 
-        if (sf::Keyboard::isKeyPressed(getKey("move_down", sett))) {
-            vel.velocity.y = PLAYER_VEL * factor;
-            movingUp = false;
-            movingDown = true;
+    const auto a = static_cast<std::size_t>(action);
+    reg.view<PlayerInputComponent>().each([&](auto& in) {
+        if (e.type == sf::Event::KeyPressed) {
+            // Ignore key repeat
+            if (!in.held.test(a)) {
+                in.held.set(a);
+                in.pressed.set(a);
+            }
+        } else if (in.held.test(a)) {
+            in.held.reset(a);
+            in.released.set(a);
         }
+    });
+}
 
-        if (sf::Keyboard::isKeyPressed(getKey("move_left", sett))) {
-            vel.velocity.x = -PLAYER_VEL * factor;
-            movingLeft = true;
-            movingRight = false;
-        }
+void InputHandler::processInput(entt::registry& reg) {
+    reg.view<PlayerInputComponent, VelocityComponent>().each(
+        [&](auto p, auto& in, auto& vel) {
+            const auto held = [&in](const Action a) {
+                return in.held.test(static_cast<std::size_t>(a));
+            };
+
+            float factor = 1.0f;
+            if (held(Action::Sprint)) {
+                factor = SHIFT_FACTOR;
+            } else if (held(Action::Sneak)) {
+                factor = CTRL_FACTOR;
+            }
 
-        if (sf::Keyboard::isKeyPressed(getKey("move_right", sett))) {
-            vel.velocity.x = PLAYER_VEL * factor;
-            movingLeft = false;
-            movingRight = true;
-        }
+            AnimationComponent* ac = reg.try_get<AnimationComponent>(p);
+            bool movingUp = false;
+            bool movingDown = false;
+            bool movingLeft = false;
+            bool movingRight = false;
 
-        if ((movingUp || movingDown) && (movingLeft || movingRight)) {
-            vel.velocity /= sqrtf(2.0f);
-        }
+            if (held(Action::MoveUp)) {
+                vel.velocity.y = -PLAYER_VEL * factor;
+                movingUp = true;
+                movingDown = false;
+            }
 
-        if (ac == nullptr) {
-            return;
-        }
+            if (held(Action::MoveDown)) {
+                vel.velocity.y = PLAYER_VEL * factor;
+                movingUp = false;
+                movingDown = true;
+            }
 
-        currentAnim = ac->getCurrentAnimation();
+            if (held(Action::MoveLeft)) {
+                vel.velocity.x = -PLAYER_VEL * factor;
+                movingLeft = true;
+                movingRight = false;
+            }
 
-        if (movingLeft && !movingUp && !movingDown) {
-            if (currentAnim != "walk_left") {
-                ac->startAnimation("walk_left", true);
+            if (held(Action::MoveRight)) {
+                vel.velocity.x = PLAYER_VEL * factor;
+                movingLeft = false;
+                movingRight = true;
             }
-        } else if (movingRight && !movingUp && !movingDown) {
-            if (currentAnim != "walk_right") {
-                ac->startAnimation("walk_right", true);
+
+            if ((movingUp || movingDown) && (movingLeft || movingRight)) {
+                vel.velocity /= sqrtf(2.0f);
             }
-        }
 
-        if (movingUp) {
-            if (currentAnim != "walk_up") {
-                ac->startAnimation("walk_up", true);
+            if (ac == nullptr) {
+                return;
             }
-        } else if (movingDown) {
-            if (currentAnim != "walk_down") {
-                ac->startAnimation("walk_down", true);
+
+            const WalkClips& clips = getWalkClips();
+            ClipId clip            = clips.idle;
+            if (movingUp) {
+                clip = clips.up;
+            } else if (movingDown) {
+                clip = clips.down;
+            } else if (movingLeft) {
+                clip = clips.left;
+            } else if (movingRight) {
+                clip = clips.right;
             }
-        }
 
-        if (!movingUp && !movingDown && !movingLeft && !movingRight) {
-            if (currentAnim != "idle") {
-                ac->startAnimation("idle", true);
+            if (ac->clip != clip) {
+                AnimationSystem::play({reg, p}, clip, true);
             }
-        }
+        });
+
+    // Edges are consumed by the tick that saw them
+    reg.view<PlayerInputComponent>().each([](auto& in) {
+        in.pressed.reset();
+        in.released.reset();
     });
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,40 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/Log.hpp>
+
+namespace nc {
+
+LogLimiter::LogLimiter(const float interval)
+    : m_interval(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<float>(interval))),
+      m_next(0), m_suppressed(0) {}
+
+bool LogLimiter::allow(unsigned int& suppressed) {
+    const Clock::rep now = Clock::now().time_since_epoch().count();
+    Clock::rep next      = m_next.load(std::memory_order_relaxed);
+
+    // Only the thread that moves the deadline forward gets to log
+    if (now < next || !m_next.compare_exchange_strong(
+                          next, now + m_interval.count(),
+                          std::memory_order_relaxed)) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+}
@@ -0,0 +1,195 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/LogConsole.hpp>
+#include <spdlog/spdlog.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+ImVec4 getLevelColor(spdlog::level::level_enum level) {
+    switch (level) {
+    case spdlog::level::trace:
+    case spdlog::level::debug:
+        return ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+    case spdlog::level::warn:
+        return ImVec4(1.0f, 0.8f, 0.3f, 1.0f);
+    case spdlog::level::err:
+    case spdlog::level::critical:
+        return ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+    default:
+        return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+}
+
+}
+
+namespace nc {
+
+LogConsole::LogConsole()
+    : m_text(TEXT_CAPACITY), m_lines(LINE_CAPACITY), m_writePos(0),
+      m_firstLine(0), m_nextLine(0), m_filteredUpTo(0), m_filter(),
+      m_minLevel(spdlog::level::trace), m_filterChanged(false),
+      m_autoScroll(true) {}
+
+void LogConsole::draw() {
+    ImGui::Begin("Console");
+
+    static const char* levels[] = {"Trace", "Debug", "Info", "Warning",
+                                   "Error", "Critical"};
+    ImGui::SetNextItemWidth(100.0f);
+    m_filterChanged |= ImGui::Combo("Level", &m_minLevel, levels,
+                                    IM_ARRAYSIZE(levels));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200.0f);
+    m_filterChanged |= ImGui::InputText("Filter", m_filter, sizeof(m_filter));
+    ImGui::SameLine();
+    ImGui::Checkbox("Auto-scroll", &m_autoScroll);
+    ImGui::Separator();
+
+    ImGui::BeginChild("lines", ImVec2(0.0f, 0.0f), false,
+                      ImGuiWindowFlags_HorizontalScrollbar);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (m_filterChanged) {
+        m_filtered.clear();
+        m_filteredUpTo  = m_firstLine;
+        m_filterChanged = false;
+    }
+
+    // Only lines logged since the last frame need checking
+    for (; m_filteredUpTo < m_nextLine; m_filteredUpTo++) {
+        if (matches(m_filteredUpTo)) {
+            m_filtered.push_back(m_filteredUpTo);
+        }
+    }
+
+    while (!m_filtered.empty() && m_filtered.front() < m_firstLine) {
+        m_filtered.pop_front();
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_filtered.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const Line& l   = m_lines[m_filtered[i] % LINE_CAPACITY];
+            const char* str = m_text.data() + l.offset;
+            ImGui::PushStyleColor(ImGuiCol_Text, getLevelColor(l.level));
+            ImGui::TextUnformatted(str, str + l.length);
+            ImGui::PopStyleColor();
+        }
+    }
+    clipper.End();
+
+    if (m_autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+        ImGui::SetScrollHereY(1.0f);
+    }
+
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+void LogConsole::sink_it_(const spdlog::details::log_msg& msg) {
+    spdlog::memory_buf_t formatted;
+    formatter_->format(msg, formatted);
+
+    std::size_t length = formatted.size();
+    while (length > 0 && (formatted[length - 1] == '\n' ||
+                          formatted[length - 1] == '\r')) {
+        length--;
+    }
+    length = std::min(length, MAX_LINE);
+
+    if (m_writePos + length > TEXT_CAPACITY) {
+        // Everything after the write position is older than anything
+        // before it, drop it and wrap around
+        while (m_firstLine < m_nextLine &&
+               m_lines[m_firstLine % LINE_CAPACITY].offset >= m_writePos) {
+            evictOldest();
+        }
+        m_writePos = 0;
+    }
+
+    // Make room for the text and the index entry
+    while (m_firstLine < m_nextLine) {
+        const Line& oldest = m_lines[m_firstLine % LINE_CAPACITY];
+        const bool overlaps =
+            oldest.offset < m_writePos + length &&
+            oldest.offset + oldest.length > m_writePos;
+        if (!overlaps && m_nextLine - m_firstLine < LINE_CAPACITY) {
+            break;
+        }
+        evictOldest();
+    }
+
+    std::memcpy(m_text.data() + m_writePos, formatted.data(), length);
+    m_lines[m_nextLine % LINE_CAPACITY] = {
+        static_cast<std::uint32_t>(m_writePos),
+        static_cast<std::uint32_t>(length), msg.level};
+    m_writePos += length;
+    m_nextLine++;
+}
+
+void LogConsole::flush_() {}
+
+void LogConsole::evictOldest() {
+    m_firstLine++;
+    m_filteredUpTo = std::max(m_filteredUpTo, m_firstLine);
+}
+
+bool LogConsole::matches(const std::uint64_t line) const {
+    const Line& l = m_lines[line % LINE_CAPACITY];
+    if (l.level < m_minLevel) {
+        return false;
+    }
+
+    if (m_filter[0] == '\0') {
+        return true;
+    }
+
+    const char* begin     = m_text.data() + l.offset;
+    const char* end       = begin + l.length;
+    const char* filterEnd = m_filter + std::strlen(m_filter);
+    return std::search(begin, end, m_filter, filterEnd) != end;
+}
+
+LogStreamBuf::LogStreamBuf(std::string prefix) : m_prefix(std::move(prefix)) {}
+
+LogStreamBuf::int_type LogStreamBuf::overflow(int_type c) {
+    if (c == traits_type::eof()) {
+        return traits_type::not_eof(c);
+    }
+
+    if (c == '\n') {
+        sync();
+    } else {
+        m_line.push_back(static_cast<char>(c));
+    }
+
+    return c;
+}
+
+int LogStreamBuf::sync() {
+    if (!m_line.empty()) {
+        spdlog::warn("{}{}", m_prefix, m_line);
+        m_line.clear();
+    }
+
+    return 0;
+}
+
+}
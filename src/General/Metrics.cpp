@@ -0,0 +1,554 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/Metrics.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <imgui.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <map>
+
+namespace {
+
+#ifdef NC_TRACK_ALLOCATIONS
+// Constant initialized, so they are usable from operator new before any
+// other static is constructed
+nc::Counter allocatedBytes;
+nc::Counter allocationCount;
+nc::Counter freeCount;
+std::atomic<std::int64_t> liveBytes{0};
+
+// Threads batch their updates so allocating doesn't contend on the shared
+// counters, at most FLUSH_EVERY operations per thread go unreported
+constexpr unsigned int FLUSH_EVERY = 64;
+
+struct PendingAllocations {
+    std::uint64_t bytes;
+    std::uint64_t allocations;
+    std::uint64_t frees;
+    std::int64_t live;
+    unsigned int ops;
+};
+
+thread_local PendingAllocations pending{};
+
+// Stored right before every block, so unsized deletes know what they free
+struct BlockHeader {
+    std::size_t size;
+    std::size_t offset; // From the start of the malloc'd block
+};
+
+constexpr std::size_t MALLOC_ALIGN = alignof(std::max_align_t);
+static_assert(sizeof(BlockHeader) <= MALLOC_ALIGN,
+              "Block header must fit in the malloc alignment");
+
+void flushAllocations() {
+    allocatedBytes.add(pending.bytes);
+    allocationCount.add(pending.allocations);
+    freeCount.add(pending.frees);
+    liveBytes.fetch_add(pending.live, std::memory_order_relaxed);
+    pending = PendingAllocations{};
+}
+
+void* allocate(const std::size_t size, std::size_t align) noexcept {
+    align = std::max<std::size_t>(align, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    align = std::max(align, MALLOC_ALIGN);
+
+    // malloc alignment and a header no larger than it keep the padding
+    // needed for header and alignment within align bytes
+    if (size > SIZE_MAX - align) {
+        return nullptr;
+    }
+
+    char* block = static_cast<char*>(std::malloc(size + align));
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block);
+    const std::uintptr_t addr =
+        (start + sizeof(BlockHeader) + align - 1) & ~(align - 1);
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(addr) - 1;
+    header->size        = size;
+    header->offset      = addr - start;
+
+    pending.bytes += size;
+    pending.allocations++;
+    pending.live += static_cast<std::int64_t>(size);
+    if (++pending.ops >= FLUSH_EVERY) {
+        flushAllocations();
+    }
+
+    return reinterpret_cast<void*>(addr);
+}
+
+void* allocateOrThrow(const std::size_t size, const std::size_t align) {
+    if (void* p = allocate(size, align)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void deallocate(void* p) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+
+    const BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+
+    pending.frees++;
+    pending.live -= static_cast<std::int64_t>(header->size);
+    if (++pending.ops >= FLUSH_EVERY) {
+        flushAllocations();
+    }
+
+    std::free(static_cast<char*>(p) - header->offset);
+}
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct Registry {
+    Registry() : lastRateSample(Clock::now()), lastDump(lastRateSample) {
+#ifdef NC_TRACK_ALLOCATIONS
+        counters["memory.bytes_allocated"] = &allocatedBytes;
+        counters["memory.allocations"]     = &allocationCount;
+        counters["memory.frees"]           = &freeCount;
+#endif
+    }
+
+    std::mutex mutex;
+    std::map<std::string, nc::Counter*> counters;
+    std::map<std::string, std::unique_ptr<nc::Counter>> ownedCounters;
+    std::map<std::string, std::unique_ptr<nc::Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<nc::Histogram>> histograms;
+    std::map<std::string, std::uint64_t> lastCounts;
+    std::map<std::string, float> rates; // Per second
+    Clock::time_point lastRateSample;
+    Clock::time_point lastDump;
+    float dumpInterval = 0.0f;
+    std::string dumpPath;
+};
+
+Registry& getRegistry() {
+    static Registry reg;
+    return reg;
+}
+
+float secondsSince(const Clock::time_point& t) {
+    return std::chrono::duration<float>(Clock::now() - t).count();
+}
+
+bool isJsonPath(const std::string& path) {
+    return std::filesystem::path(path).extension() == ".json";
+}
+
+}
+
+#ifdef NC_TRACK_ALLOCATIONS
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return allocateOrThrow(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return allocateOrThrow(size, static_cast<std::size_t>(align));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(align));
+}
+
+// Every block carries its size, so all deletes share one path
+void operator delete(void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+#endif
+
+namespace nc {
+
+void Counter::add(const std::uint64_t n) {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+}
+
+std::uint64_t Counter::get() const {
+    return m_value.load(std::memory_order_relaxed);
+}
+
+void Gauge::set(const std::int64_t value) {
+    m_value.store(value, std::memory_order_relaxed);
+}
+
+void Gauge::add(const std::int64_t n) {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+}
+
+std::int64_t Gauge::get() const {
+    return m_value.load(std::memory_order_relaxed);
+}
+
+void Histogram::record(const float seconds) {
+    const float us      = seconds * 1e6f;
+    unsigned int bucket = 0;
+
+    if (us >= 1.0f) {
+        int exp;
+        const float mantissa = std::frexp(us, &exp); // us = m * 2^exp
+        const auto sub = static_cast<unsigned int>((mantissa * 2.0f - 1.0f) *
+                                                   SUB_BUCKETS);
+        bucket         = 1 + static_cast<unsigned int>(exp - 1) * SUB_BUCKETS +
+                 std::min(sub, SUB_BUCKETS - 1);
+        bucket = std::min(bucket, BUCKET_NO - 1);
+    }
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(static_cast<std::uint64_t>(us), std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::getCount() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+float Histogram::getMean() const {
+    const std::uint64_t count = getCount();
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    return static_cast<float>(m_sum.load(std::memory_order_relaxed)) /
+           static_cast<float>(count) / 1e6f;
+}
+
+float Histogram::getPercentile(const float p) const {
+    const std::uint64_t count = getCount();
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    const auto target = static_cast<std::uint64_t>(
+        std::ceil(static_cast<double>(p) * static_cast<double>(count)));
+    std::uint64_t seen = 0;
+    for (unsigned int i = 0; i < BUCKET_NO; i++) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return getUpperBound(i) / 1e6f;
+        }
+    }
+
+    return getUpperBound(BUCKET_NO - 1) / 1e6f;
+}
+
+float Histogram::getUpperBound(const unsigned int bucket) {
+    if (bucket == 0) {
+        return 1.0f;
+    }
+
+    const unsigned int octave = (bucket - 1) / SUB_BUCKETS;
+    const unsigned int sub    = (bucket - 1) % SUB_BUCKETS;
+
+    return std::ldexp(1.0f + static_cast<float>(sub + 1) / SUB_BUCKETS,
+                      static_cast<int>(octave));
+}
+
+Counter& Metrics::getCounter(const std::string& name) {
+    Registry& reg = getRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto it = reg.counters.find(name);
+    if (it == reg.counters.end()) {
+        auto& owned = reg.ownedCounters[name];
+        owned       = std::make_unique<Counter>();
+        it          = reg.counters.emplace(name, owned.get()).first;
+    }
+
+    return *it->second;
+}
+
+Gauge& Metrics::getGauge(const std::string& name) {
+    Registry& reg = getRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto& g = reg.gauges[name];
+    if (g == nullptr) {
+        g = std::make_unique<Gauge>();
+    }
+
+    return *g;
+}
+
+Histogram& Metrics::getHistogram(const std::string& name) {
+    Registry& reg = getRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto& h = reg.histograms[name];
+    if (h == nullptr) {
+        h = std::make_unique<Histogram>();
+    }
+
+    return *h;
+}
+
+void Metrics::setDumpInterval(const float seconds, const std::string& path) {
+    Registry& reg = getRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    reg.dumpInterval = seconds;
+    reg.dumpPath     = path;
+    reg.lastDump     = Clock::now();
+}
+
+void Metrics::update() {
+#ifdef NC_TRACK_ALLOCATIONS
+    getGauge("memory.live_bytes")
+        .set(liveBytes.load(std::memory_order_relaxed));
+#endif
+
+    Registry& reg = getRegistry();
+    std::string dumpPath;
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        const float elapsed = secondsSince(reg.lastRateSample);
+        if (elapsed >= 1.0f) {
+            for (const auto& c : reg.counters) {
+                const std::uint64_t value = c.second->get();
+                reg.rates[c.first] =
+                    static_cast<float>(value - reg.lastCounts[c.first]) /
+                    elapsed;
+                reg.lastCounts[c.first] = value;
+            }
+            reg.lastRateSample = Clock::now();
+        }
+
+        if (reg.dumpInterval > 0.0f &&
+            secondsSince(reg.lastDump) >= reg.dumpInterval) {
+            reg.lastDump = Clock::now();
+            dumpPath     = reg.dumpPath;
+        }
+    }
+
+    if (!dumpPath.empty()) {
+        dump(dumpPath);
+    }
+}
+
+bool Metrics::dump(const std::string& path) {
+    Registry& reg      = getRegistry();
+    const bool json    = isJsonPath(path);
+    const bool newFile = !std::filesystem::exists(path);
+    std::ofstream o(path, std::ios::app);
+
+    if (!o) {
+        spdlog::error("Could not open metrics file {}!", path);
+        return false;
+    }
+
+    const auto timestamp =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    if (json) {
+        // One JSON document per line, so the file can be streamed
+        nlohmann::json j;
+        j["timestamp"] = timestamp;
+        for (const auto& c : reg.counters) {
+            j["counters"][c.first] = {{"value", c.second->get()},
+                                      {"rate", reg.rates[c.first]}};
+        }
+        for (const auto& g : reg.gauges) {
+            j["gauges"][g.first] = g.second->get();
+        }
+        for (const auto& h : reg.histograms) {
+            j["histograms"][h.first] = {
+                {"count", h.second->getCount()},
+                {"mean", h.second->getMean()},
+                {"p50", h.second->getPercentile(0.5f)},
+                {"p99", h.second->getPercentile(0.99f)},
+                {"p999", h.second->getPercentile(0.999f)}};
+        }
+        o << j << '\n';
+    } else {
+        if (newFile) {
+            o << "timestamp,name,type,value,rate,mean,p50,p99,p999\n";
+        }
+        for (const auto& c : reg.counters) {
+            o << timestamp << ',' << c.first << ",counter," << c.second->get()
+              << ',' << reg.rates[c.first] << ",,,,\n";
+        }
+        for (const auto& g : reg.gauges) {
+            o << timestamp << ',' << g.first << ",gauge," << g.second->get()
+              << ",,,,,\n";
+        }
+        for (const auto& h : reg.histograms) {
+            o << timestamp << ',' << h.first << ",histogram,"
+              << h.second->getCount() << ",," << h.second->getMean() << ','
+              << h.second->getPercentile(0.5f) << ','
+              << h.second->getPercentile(0.99f) << ','
+              << h.second->getPercentile(0.999f) << '\n';
+        }
+    }
+
+    return true;
+}
+
+void Metrics::drawWindow() {
+    Registry& reg = getRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    ImGui::Begin("Metrics");
+
+    if (ImGui::BeginTable("counters", 3, ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Counter");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableSetupColumn("Per second");
+        ImGui::TableHeadersRow();
+        for (const auto& c : reg.counters) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(c.first.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu",
+                        static_cast<unsigned long long>(c.second->get()));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", reg.rates[c.first]);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::BeginTable("gauges", 2, ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Gauge");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableHeadersRow();
+        for (const auto& g : reg.gauges) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(g.first.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", static_cast<long long>(g.second->get()));
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::BeginTable("histograms", 5, ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Histogram (ms)");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("p999");
+        ImGui::TableHeadersRow();
+        for (const auto& h : reg.histograms) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(h.first.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(
+                                    h.second->getCount()));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", h.second->getPercentile(0.5f) * 1000.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", h.second->getPercentile(0.99f) * 1000.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", h.second->getPercentile(0.999f) * 1000.0f);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+}
@@ -29,6 +29,10 @@ Object::Object(const std::string& texture, sf::Vector2u size)
 }
 
 void Object::setTexture(const std::string& texture) {
+    if (Game::getInstance()->isHeadless()) {
+        return;
+    }
+
     sf::Sprite::setTexture(
         Game::getInstance()->getTextureAtlas().getTexture(texture));
 }
@@ -44,6 +48,10 @@ void Object::setSize(sf::Vector2u size) {
     const float texHeight =
         static_cast<float>(sf::Sprite::getTextureRect().height);
 
+    if (texWidth == 0.0f || texHeight == 0.0f) {
+        return;
+    }
+
     sf::Sprite::setScale(
         static_cast<float>(size.x) / static_cast<float>(texWidth),
         static_cast<float>(size.y) / static_cast<float>(texHeight));
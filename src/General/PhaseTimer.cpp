@@ -0,0 +1,57 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/PhaseTimer.hpp>
+#include <spdlog/spdlog.h>
+
+namespace nc {
+
+PhaseTimer::PhaseTimer() : m_lastMark(0.0f) {}
+
+void PhaseTimer::mark(const std::string& name) {
+    const float now = getElapsed();
+    m_phases.push_back({name, now - m_lastMark, now});
+    m_lastMark = now;
+}
+
+float PhaseTimer::getElapsed() const {
+    return m_clock.getElapsedTime().asSeconds();
+}
+
+const std::vector<PhaseTimer::Phase>& PhaseTimer::getPhases() const {
+    return m_phases;
+}
+
+void PhaseTimer::log(const std::string& title) const {
+    spdlog::info("{} took {:.1f} ms:", title, m_lastMark * 1000.0f);
+    for (const Phase& p : m_phases) {
+        spdlog::info("\t{:<16} {:8.2f} ms (at {:.1f} ms)", p.name,
+                     p.duration * 1000.0f, p.end * 1000.0f);
+    }
+}
+
+nlohmann::json PhaseTimer::toJson() const {
+    nlohmann::json j;
+    j["total_ms"] = m_lastMark * 1000.0f;
+    j["phases"]   = nlohmann::json::array();
+    for (const Phase& p : m_phases) {
+        j["phases"].push_back({{"name", p.name},
+                               {"ms", p.duration * 1000.0f},
+                               {"end_ms", p.end * 1000.0f}});
+    }
+
+    return j;
+}
+
+}
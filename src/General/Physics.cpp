@@ -15,7 +15,10 @@
 #include <General/Physics.hpp>
 #include <Components/VelocityComponent.hpp>
 #include <Components/CollisionBoxComponent.hpp>
+#include <Components/LodComponent.hpp>
 #include <General/Object.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
 #include <World/Map.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <limits>
@@ -23,13 +26,21 @@
 
 namespace nc {
 
-void Physics::simulate(entt::registry& reg, float dt, Map* map) {
-    reg.view<VelocityComponent, Object>().each(
-        [&](auto ent, auto& vel, auto& obj) {
-            if (vel.velocity.x == 0.0f && vel.velocity.y == 0.0f) {
+void Physics::simulate(entt::registry& reg, Map* map) {
+    NC_PROFILE_FUNCTION();
+    static Gauge& movingGauge = Metrics::getGauge("physics.moving_entities");
+    std::int64_t moving       = 0;
+
+    reg.view<VelocityComponent, Object, const LodComponent>().each(
+        [&](auto ent, auto& vel, auto& obj, const auto& lod) {
+            const float dt = lod.step;
+            if (dt == 0.0f ||
+                (vel.velocity.x == 0.0f && vel.velocity.y == 0.0f)) {
                 return;
             }
 
+            moving++;
+
             sf::Vector2f velocity = vel.velocity * dt;
 
             // Handle collisions
@@ -49,14 +60,14 @@ void Physics::simulate(entt::registry& reg, float dt, Map* map) {
             }
 
             // Find magnitude of movement vector
-            const float mag = std::sqrtf(vel.velocity.x * vel.velocity.x +
+            const float mag = std::sqrt(vel.velocity.x * vel.velocity.x +
                                          vel.velocity.y * vel.velocity.y);
 
             // Find deceleration vector
             if (mag != 0.0f) {
                 const sf::Vector2f dec =
                     vel.velocity * (-1.0f / mag * VELOCITY_DECEL) * dt;
-                const float decMag = std::sqrtf(dec.x * dec.x + dec.y * dec.y);
+                const float decMag = std::sqrt(dec.x * dec.x + dec.y * dec.y);
 
                 // Decelerate
                 if (decMag >= mag) {
@@ -67,6 +78,8 @@ void Physics::simulate(entt::registry& reg, float dt, Map* map) {
                 }
             }
         });
+
+    movingGauge.set(moving);
 }
 
 void Physics::handleWorldCollision(const CollisionBoxComponent* cb,
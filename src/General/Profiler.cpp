@@ -0,0 +1,298 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/Profiler.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <imgui.h>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct ThreadView {
+    std::string name;
+    std::vector<nc::ProfileSample> samples;
+    std::uint32_t depth;
+};
+
+const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();
+
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<nc::ProfileBuffer>> buffers;
+
+thread_local nc::ProfileBuffer* threadBuffer = nullptr;
+thread_local std::uint32_t threadDepth       = 0;
+
+std::array<std::atomic<std::int64_t>, nc::Profiler::FRAME_NO> frameStarts;
+std::atomic<std::uint64_t> frameCount{0};
+
+ImU32 getZoneColor(const char* name) {
+    const std::size_t h = std::hash<const void*>()(name);
+    const float hue     = static_cast<float>(h % 360) / 360.0f;
+
+    return ImColor::HSV(hue, 0.45f, 0.75f);
+}
+
+}
+
+namespace nc {
+
+ProfileBuffer::ProfileBuffer(std::uint32_t id, std::string name)
+    : m_samples(), m_head(0), m_id(id), m_name(std::move(name)) {}
+
+void ProfileBuffer::push(const ProfileSample& sample) {
+    const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    m_samples[head % CAPACITY] = sample;
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void ProfileBuffer::snapshot(std::vector<ProfileSample>& out) const {
+    const std::uint64_t head  = m_head.load(std::memory_order_acquire);
+    const std::uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+    const std::size_t offset  = out.size();
+
+    for (std::uint64_t i = first; i < head; i++) {
+        out.push_back(m_samples[i % CAPACITY]);
+    }
+
+    // The writer may have lapped us while copying, drop anything that could
+    // have been overwritten in the meantime
+    const std::uint64_t newHead = m_head.load(std::memory_order_acquire);
+    if (newHead > first + CAPACITY) {
+        const std::uint64_t stale =
+            std::min<std::uint64_t>(newHead - first - CAPACITY, head - first);
+        out.erase(out.begin() + offset, out.begin() + offset + stale);
+    }
+}
+
+std::uint32_t ProfileBuffer::getId() const {
+    return m_id;
+}
+
+const std::string& ProfileBuffer::getName() const {
+    return m_name;
+}
+
+void ProfileBuffer::setName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    m_name = name;
+}
+
+std::int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+ProfileBuffer& Profiler::getThreadBuffer() {
+    if (threadBuffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        const auto id = static_cast<std::uint32_t>(buffers.size());
+        buffers.push_back(std::make_unique<ProfileBuffer>(
+            id, "Thread " + std::to_string(id)));
+        threadBuffer = buffers.back().get();
+    }
+
+    return *threadBuffer;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    getThreadBuffer().setName(name);
+}
+
+void Profiler::markFrame() {
+    const std::uint64_t frame = frameCount.load(std::memory_order_relaxed);
+    frameStarts[frame % FRAME_NO].store(now(), std::memory_order_relaxed);
+    frameCount.store(frame + 1, std::memory_order_release);
+}
+
+bool Profiler::exportTrace(const std::string& path) {
+    nlohmann::json events = nlohmann::json::array();
+    std::vector<ProfileSample> samples;
+
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const auto& b : buffers) {
+            events.push_back({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", 1},
+                              {"tid", b->getId()},
+                              {"args", {{"name", b->getName()}}}});
+
+            samples.clear();
+            b->snapshot(samples);
+            for (const auto& s : samples) {
+                events.push_back(
+                    {{"name", s.name},
+                     {"cat", "nanocraft"},
+                     {"ph", "X"},
+                     {"pid", 1},
+                     {"tid", b->getId()},
+                     {"ts", static_cast<double>(s.start) / 1000.0},
+                     {"dur", static_cast<double>(s.end - s.start) / 1000.0}});
+            }
+        }
+    }
+
+    std::ofstream o(path);
+    if (!o) {
+        spdlog::error("Could not open trace file {}!", path);
+        return false;
+    }
+
+    nlohmann::json trace;
+    trace["traceEvents"]     = std::move(events);
+    trace["displayTimeUnit"] = "ms";
+    o << trace;
+    spdlog::info("Exported profiler trace to {}", path);
+
+    return true;
+}
+
+void Profiler::drawWindow() {
+    static bool paused     = false;
+    static int framesShown = 3;
+    static std::vector<ThreadView> threads;
+    static std::int64_t viewStart = 0;
+    static std::int64_t viewEnd   = 0;
+    static std::vector<std::int64_t> frameMarks;
+
+    ImGui::Begin("Profiler");
+    ImGui::Checkbox("Pause", &paused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150.0f);
+    ImGui::SliderInt("Frames", &framesShown, 1,
+                     static_cast<int>(FRAME_NO) - 1);
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) {
+        exportTrace("trace.json");
+    }
+
+    const std::uint64_t frames = frameCount.load(std::memory_order_acquire);
+    const auto shown           = static_cast<std::uint64_t>(framesShown);
+    if (!paused && frames > shown) {
+        // The view spans the last completed frames, up to the start of the
+        // frame currently being recorded
+        viewEnd   = frameStarts[(frames - 1) % FRAME_NO].load();
+        viewStart = frameStarts[(frames - 1 - shown) % FRAME_NO].load();
+        frameMarks.clear();
+        for (std::uint64_t f = frames - 1 - shown; f < frames; f++) {
+            frameMarks.push_back(frameStarts[f % FRAME_NO].load());
+        }
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        threads.resize(buffers.size());
+        for (std::size_t i = 0; i < buffers.size(); i++) {
+            ThreadView& tv = threads[i];
+            tv.name        = buffers[i]->getName();
+            tv.depth       = 0;
+            tv.samples.clear();
+            buffers[i]->snapshot(tv.samples);
+            tv.samples.erase(std::remove_if(tv.samples.begin(),
+                                            tv.samples.end(),
+                                            [](const ProfileSample& s) {
+                                                return s.end < viewStart ||
+                                                       s.start > viewEnd;
+                                            }),
+                             tv.samples.end());
+            for (const auto& s : tv.samples) {
+                tv.depth = std::max(tv.depth, s.depth + 1);
+            }
+        }
+    }
+
+    if (viewEnd <= viewStart) {
+        ImGui::TextUnformatted("Waiting for frames...");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("%.3f ms over %d frames",
+                static_cast<double>(viewEnd - viewStart) / 1e6, framesShown);
+
+    constexpr float rowHeight = 18.0f;
+    ImDrawList* dl            = ImGui::GetWindowDrawList();
+    const float width         = std::max(ImGui::GetContentRegionAvail().x,
+                                         100.0f);
+    const double scale = width / static_cast<double>(viewEnd - viewStart);
+
+    for (const auto& tv : threads) {
+        if (tv.samples.empty()) {
+            continue;
+        }
+
+        ImGui::TextUnformatted(tv.name.c_str());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float height  = static_cast<float>(tv.depth) * rowHeight;
+
+        dl->PushClipRect(origin, ImVec2(origin.x + width, origin.y + height),
+                         true);
+        for (const auto m : frameMarks) {
+            const float x = origin.x + static_cast<float>(
+                                           static_cast<double>(m - viewStart) *
+                                           scale);
+            dl->AddLine(ImVec2(x, origin.y), ImVec2(x, origin.y + height),
+                        IM_COL32(255, 255, 255, 64));
+        }
+
+        for (const auto& s : tv.samples) {
+            const float x0 =
+                origin.x + static_cast<float>(
+                               static_cast<double>(s.start - viewStart) *
+                               scale);
+            const float x1 = std::max(
+                x0 + 1.0f,
+                origin.x + static_cast<float>(
+                               static_cast<double>(s.end - viewStart) *
+                               scale));
+            const float y0 =
+                origin.y + static_cast<float>(s.depth) * rowHeight;
+            const ImVec2 min(x0, y0);
+            const ImVec2 max(x1, y0 + rowHeight - 1.0f);
+
+            dl->AddRectFilled(min, max, getZoneColor(s.name));
+            if (ImGui::CalcTextSize(s.name).x < x1 - x0 - 4.0f) {
+                dl->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f),
+                            IM_COL32(0, 0, 0, 255), s.name);
+            }
+
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3f ms", s.name,
+                                  static_cast<double>(s.end - s.start) / 1e6);
+            }
+        }
+        dl->PopClipRect();
+
+        ImGui::Dummy(ImVec2(width, height));
+    }
+
+    ImGui::End();
+}
+
+ProfileZone::ProfileZone(const char* name)
+    : m_name(name), m_start(Profiler::now()), m_depth(threadDepth++) {}
+
+ProfileZone::~ProfileZone() {
+    threadDepth--;
+    Profiler::getThreadBuffer().push({m_name, m_start, Profiler::now(),
+                                      m_depth});
+}
+
+}
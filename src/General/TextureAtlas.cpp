@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #include <General/TextureAtlas.hpp>
-#include <physfs.h>
+#include <General/Log.hpp>
+#include <General/FileReader.hpp>
 #include <spdlog/spdlog.h>
 
 namespace nc {
 
-TextureAtlas::TextureAtlas() {
+TextureAtlas::TextureAtlas() {}
+
+void TextureAtlas::createDefaultTexture() {
     // Create default texture
     sf::Image img;
     img.create(16, 16, sf::Color::Magenta);
@@ -28,47 +31,43 @@ TextureAtlas::TextureAtlas() {
     m_textures["default"] = std::move(t);
 }
 
-bool TextureAtlas::addTexture(const std::filesystem::path& path) {
-    bool couldLoad          = true;
-    PHYSFS_File* fileHandle = PHYSFS_openRead(path.string().c_str());
-    PHYSFS_sint64 fileSize;
-    PHYSFS_sint64 read;
-    unsigned char* fileData = nullptr;
-    if (fileHandle == NULL) {
-        spdlog::warn("Could not open texture {}!", path.string());
-        spdlog::warn("Using default texture!");
-        couldLoad = false;
-    } else {
-        fileSize = PHYSFS_fileLength(fileHandle);
-        if (fileSize == -1) {
-            spdlog::warn("Could not retreive file size for texture {}!",
-                         path.string());
-            spdlog::warn("Using default texture!");
-            couldLoad = false;
-        }
-        fileData = new unsigned char[fileSize];
-        read     = PHYSFS_readBytes(fileHandle, fileData, fileSize);
-        if (read < fileSize && couldLoad) {
-            spdlog::warn("Could not read texture {}!", path.string());
-            spdlog::warn("Using default texture!");
-            couldLoad = false;
-        }
-        PHYSFS_close(fileHandle);
-    }
+bool TextureAtlas::decodeImage(const std::string& path, sf::Image& img) {
+    // The encoded file is only needed until it is decoded
+    FileReader& reader = FileReader::getLocal();
+    const bool couldLoad =
+        reader.read(path) &&
+        img.loadFromMemory(reader.getData(), reader.getSize());
 
-    sf::Image img;
-    if (couldLoad) {
-        img.loadFromMemory(fileData, fileSize);
-    } else {
+    if (!couldLoad) {
+        spdlog::warn("Using default texture!");
         img.create(16, 16, sf::Color::Magenta);
     }
 
-    delete[] fileData;
+    return couldLoad;
+}
 
+void TextureAtlas::addTexture(const std::string& path, const sf::Image& img) {
     sf::Texture t;
     t.loadFromImage(img);
 
-    m_textures[path.string()] = std::move(t);
+    m_textures[path] = std::move(t);
+}
+
+void TextureAtlas::addTexture(const std::string& path,
+                              const unsigned char* pixels,
+                              const unsigned int width,
+                              const unsigned int height) {
+    sf::Texture t;
+    t.create(width, height);
+    t.update(pixels);
+
+    m_textures[path] = std::move(t);
+}
+
+bool TextureAtlas::addTexture(const std::filesystem::path& path) {
+    sf::Image img;
+    const bool couldLoad = decodeImage(path.string(), img);
+    addTexture(path.string(), img);
 
     return couldLoad;
 }
@@ -81,13 +80,15 @@ const sf::Texture& TextureAtlas::getTexture(const std::string& texture) const {
         actualPath = texture;
     }
 
-    if (m_textures.find(actualPath) == m_textures.end()) {
-        spdlog::warn("Could not find texture {}! Using default one!",
-                     actualPath);
+    const auto it = m_textures.find(actualPath);
+    if (it == m_textures.end()) {
+        NC_LOG_LIMITED(1.0f, spdlog::level::warn,
+                       "Could not find texture {}! Using default one!",
+                       actualPath);
         return m_textures.at("default");
     }
 
-    return m_textures.at(actualPath);
+    return it->second;
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <General/ThreadPool.hpp>
+#include <General/Profiler.hpp>
+#include <algorithm>
+#include <string>
+
+namespace nc {
+
+ThreadPool::ThreadPool(unsigned int threadNo) : m_stop(false) {
+    if (threadNo == 0) {
+        threadNo = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_threads.reserve(threadNo);
+    for (unsigned int i = 0; i < threadNo; i++) {
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    // Queued jobs still run, so no future is left without a value
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+    m_threads.clear();
+}
+
+unsigned int ThreadPool::getThreadNo() const {
+    return static_cast<unsigned int>(m_threads.size());
+}
+
+void ThreadPool::enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+void ThreadPool::work(const unsigned int index) {
+    NC_PROFILE_THREAD("Worker " + std::to_string(index));
+
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+        }
+
+        job();
+    }
+}
+
+}
@@ -19,6 +19,5 @@ SFML_DEFINE_DISCRETE_GPU_PREFERENCE
 
 int main(int argc, char** argv) {
     nc::Game g(argc, argv);
-    g.run();
-    return 0;
+    return g.run();
 }
\ No newline at end of file
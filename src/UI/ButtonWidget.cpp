@@ -41,6 +41,11 @@ void ButtonWidget::setOnClick(std::function<void()> func) {
 }
 
 void ButtonWidget::setTexture(State state, const std::string& texture) {
+    if (Game::getInstance()->isHeadless()) {
+        m_stateTextures[state] = nullptr;
+        return;
+    }
+
     m_stateTextures[state] =
         &Game::getInstance()->getTextureAtlas().getTexture(texture);
 }
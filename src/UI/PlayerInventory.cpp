@@ -13,7 +13,6 @@
 // limitations under the License.
 
 #include <UI/PlayerInventory.hpp>
-#include <Components/InventoryComponent.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
 namespace nc {
@@ -46,7 +45,8 @@ void PlayerInventory::update() {
 
         for (unsigned int y = 0; y < PLAYER_INV_ROWS; y++) {
             for (unsigned int x = 0; x < PLAYER_INV_COLS; x++) {
-                Item* itm = inv.inventory[y * PLAYER_INV_COLS + x].getItem();
+                const Item* itm =
+                    inv.getSlot(y * PLAYER_INV_COLS + x).getItem();
                 if (itm != nullptr) {
                     const sf::Texture* itemTex = itm->getSprite().getTexture();
 
@@ -13,7 +13,6 @@
 // limitations under the License.
 
 #include <UI/PlayerUI.hpp>
-#include <Components/InventoryComponent.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
 namespace nc {
@@ -28,7 +27,7 @@ PlayerUI::PlayerUI()
                           UI::REFERENCE_HEIGHT - height);
     addWidget(&m_toolBar);
 
-    for (unsigned int i = 0; i < 9; i++) {
+    for (unsigned int i = 0; i < PlayerInventory::HOTBAR_SIZE; i++) {
         m_toolBarImages[i].setParent(&m_toolBar);
         m_toolBarImages[i].setPosition(static_cast<float>(i) * 25.0f + 9.0f, 9.0f);
         m_toolBarImages[i].setShown(false);
@@ -44,8 +43,9 @@ void PlayerUI::update() {
     if (m_player.valid()) {
         const InventoryComponent& inv = m_player.get<InventoryComponent>();
 
-        for (int i = 0; i < 9; i++) {
-            Item* itm = inv.inventory[4 * 9 + i].getItem();
+        for (unsigned int i = 0; i < PlayerInventory::HOTBAR_SIZE; i++) {
+            const Item* itm =
+                inv.getSlot(PlayerInventory::HOTBAR_START + i).getItem();
             if (itm != nullptr) {
                 const sf::Texture* itemTex = itm->getSprite().getTexture();
 
@@ -69,8 +69,8 @@ void PlayerUI::setPlayer(entt::const_handle player) {
 }
 
 void PlayerUI::selectHotbarItem(unsigned int pos) {
-    if (pos >= 9) {
-        pos = 8;
+    if (pos >= PlayerInventory::HOTBAR_SIZE) {
+        pos = PlayerInventory::HOTBAR_SIZE - 1;
     }
 
     m_selectedPos = pos;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <UI/UI.hpp>
+#include <General/Metrics.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
 namespace nc {
@@ -59,12 +60,14 @@ void UI::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         return;
     }
 
-    const sf::View v = target.getView();
+    static Counter& drawCalls = Metrics::getCounter("render.draw_calls");
+    const sf::View v          = target.getView();
 
     target.setView(m_view);
     for (const auto& w : m_widgets) {
         if (w->getShown() == true) {
             w->draw(target, states);
+            drawCalls.add();
         }
     }
 
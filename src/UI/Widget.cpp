@@ -84,6 +84,10 @@ sf::Vector2f Widget::getPosition() const {
 }
 
 void Widget::setTexture(const std::string& texture) {
+    if (Game::getInstance()->isHeadless()) {
+        return;
+    }
+
     m_sprite.setTexture(
         Game::getInstance()->getTextureAtlas().getTexture(texture));
 }
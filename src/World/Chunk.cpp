@@ -15,18 +15,18 @@
 #include <World/Chunk.hpp>
 #include <Game/Game.hpp>
 #include <World/Map.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
 namespace nc {
 
 Chunk::Chunk(const unsigned int xPos, const unsigned int yPos)
-    : m_xPos(xPos), m_yPos(yPos), m_dirty(true) {
-    m_tex.create(CHUNK_SIZE * TextureAtlas::TILE_SIZE,
-                 CHUNK_SIZE * TextureAtlas::TILE_SIZE);
+    : m_xPos(xPos), m_yPos(yPos), m_randomTicked(0), m_tickTime(0.0f),
+      m_tickCost(0.0f), m_dirty(true), m_overlay(nullptr) {
     m_sprite.setScale(1.0f / static_cast<float>(TextureAtlas::TILE_SIZE),
                       1.0f / static_cast<float>(TextureAtlas::TILE_SIZE));
     m_sprite.setPosition(Map::getGlobalPos(xPos, yPos));
-    m_sprite.setTexture(m_tex.getTexture());
 
     for (unsigned int y = 0; y < CHUNK_SIZE; y++) {
         for (unsigned int x = 0; x < CHUNK_SIZE; x++) {
@@ -38,6 +38,8 @@ Chunk::Chunk(const unsigned int xPos, const unsigned int yPos)
 }
 
 void Chunk::setTile(Tile* tile, unsigned int xPos, unsigned int yPos) {
+    m_randomTicked -= m_tiles[yPos][xPos].hasRandomTick();
+    m_randomTicked += tile->hasRandomTick();
     m_tiles[yPos][xPos] = *tile;
     m_tiles[yPos][xPos].setPosition(
             static_cast<float>(xPos * TextureAtlas::TILE_SIZE),
@@ -71,22 +73,66 @@ sf::Vector2u Chunk::getPosition() const {
     return sf::Vector2u(m_xPos, m_yPos);
 }
 
+unsigned int Chunk::getRandomTicked() const {
+    return m_randomTicked;
+}
+
+void Chunk::addTickTime(const float seconds) {
+    m_tickTime += seconds;
+}
+
+float Chunk::commitTickTime() {
+    const float seconds = m_tickTime;
+    m_tickCost += (seconds - m_tickCost) * TICK_COST_SMOOTHING;
+    m_tickTime = 0.0f;
+    return seconds;
+}
+
+float Chunk::getTickCost() const {
+    return m_tickCost;
+}
+
+void Chunk::setOverlay(const sf::Drawable* overlay) {
+    m_overlay = overlay;
+    m_dirty   = true;
+}
+
 void Chunk::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    NC_PROFILE_SCOPE("Chunk::draw");
+    static Counter& redraws   = Metrics::getCounter("render.chunk_redraws");
+    static Counter& drawCalls = Metrics::getCounter("render.draw_calls");
+
+    if (m_tex == nullptr) {
+        // Chunks that are only simulated never need a render texture
+        m_tex = std::make_unique<sf::RenderTexture>();
+        m_tex->create(CHUNK_SIZE * TextureAtlas::TILE_SIZE,
+                      CHUNK_SIZE * TextureAtlas::TILE_SIZE);
+        m_sprite.setTexture(m_tex->getTexture());
+        m_dirty = true;
+    }
+
     if (m_dirty) {
-        m_tex.clear(sf::Color::Yellow);
+        redraws.add();
+        drawCalls.add(CHUNK_SIZE * CHUNK_SIZE);
+        m_tex->clear(sf::Color::Yellow);
 
         for (const auto& tileRow : m_tiles) {
             for (const auto& tile : tileRow) {
-                m_tex.draw(tile);
+                m_tex->draw(tile);
             }
         }
+        if (m_overlay != nullptr) {
+            m_tex->draw(*m_overlay);
+            drawCalls.add();
+        }
 
-        m_tex.display();
+        m_tex->display();
 
         m_dirty = false;
     }
 
     target.draw(m_sprite);
+    drawCalls.add();
 }
 
 }
@@ -0,0 +1,535 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <World/FlowFields.hpp>
+#include <World/Map.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace {
+
+constexpr unsigned int SIZE             = nc::FlowFields::SIZE;
+constexpr std::uint16_t NO_DISTANCE     = 0xffff;
+constexpr std::uint8_t NO_SIDE          = 0xff;
+constexpr unsigned int MAX_PORTAL_INDEX = 0xff;
+
+// Per side, and per direction code minus one
+const sf::Vector2i DIRECTIONS[] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+
+// Tile index at a position along the edge on a side
+std::uint16_t getEdgeTile(const unsigned int side, const unsigned int i) {
+    switch (side) {
+    case 0:
+        return static_cast<std::uint16_t>(i);
+    case 1:
+        return static_cast<std::uint16_t>((SIZE - 1) * SIZE + i);
+    case 2:
+        return static_cast<std::uint16_t>(i * SIZE);
+    default:
+        return static_cast<std::uint16_t>(i * SIZE + SIZE - 1);
+    }
+}
+
+// Calls f(neighbour, direction code) for the tiles around one in a sector
+template <typename F>
+void forNeighbours(const std::uint16_t tile, F f) {
+    const unsigned int x = tile % SIZE;
+    const unsigned int y = tile / SIZE;
+    if (y > 0) {
+        f(static_cast<std::uint16_t>(tile - SIZE), 1);
+    }
+    if (y < SIZE - 1) {
+        f(static_cast<std::uint16_t>(tile + SIZE), 2);
+    }
+    if (x > 0) {
+        f(static_cast<std::uint16_t>(tile - 1), 3);
+    }
+    if (x < SIZE - 1) {
+        f(static_cast<std::uint16_t>(tile + 1), 4);
+    }
+}
+
+template <typename T>
+using MinQueue =
+    std::priority_queue<T, std::vector<T>, std::greater<T>>;
+
+}
+
+namespace nc {
+
+FlowFields::FlowFields(Map& map) : m_map(map), m_graphVersion(0) {}
+
+void FlowFields::setGoal(const GoalId goal, const sf::Vector2u tile) {
+    const auto [it, inserted] = m_goals.try_emplace(goal);
+    if (inserted || it->second.tile != tile) {
+        it->second.tile     = tile;
+        it->second.searched = false;
+    }
+}
+
+void FlowFields::removeGoal(const GoalId goal) {
+    m_goals.erase(goal);
+}
+
+sf::Vector2i FlowFields::getDirection(const GoalId goal,
+                                      const sf::Vector2u tile) {
+    const auto it = m_goals.find(goal);
+    if (it == m_goals.end()) {
+        return sf::Vector2i();
+    }
+
+    rebuildDirty();
+    Goal& g = it->second;
+    // Walls around the goal change the costs to its own sector's portals
+    // even when the graph between portals stays the same
+    const Sector* gs = getSector(g.sector);
+    if (!g.searched || g.graphVersion != m_graphVersion ||
+        (gs != nullptr && gs->generation != g.generation)) {
+        search(g);
+    }
+
+    const SectorField* f =
+        getField(g, getSectorKey(tile.x / SIZE, tile.y / SIZE));
+    if (f == nullptr) {
+        return sf::Vector2i();
+    }
+
+    const std::uint8_t code =
+        f->directions[(tile.y % SIZE) * SIZE + tile.x % SIZE];
+    return code == 0 ? sf::Vector2i() : DIRECTIONS[code - 1];
+}
+
+void FlowFields::invalidateTile(const unsigned int x, const unsigned int y) {
+    const unsigned int cx    = x / SIZE;
+    const unsigned int cy    = y / SIZE;
+    const std::uint32_t key  = getSectorKey(cx, cy);
+    const std::uint16_t tile = static_cast<std::uint16_t>(
+        (y % SIZE) * SIZE + x % SIZE);
+
+    const Tile* t = m_map.getTile(x, y);
+    if (t == nullptr) {
+        return;
+    }
+
+    // Swapping one walkable tile for another changes no path
+    const auto it = m_sectors.find(key);
+    if (it != m_sectors.end() && !it->second.dirty &&
+        it->second.blocked[tile] == t->isCollidable()) {
+        return;
+    }
+
+    markDirty(key);
+    if (y % SIZE == 0) {
+        markDirty(getSectorKey(cx, cy - 1));
+    } else if (y % SIZE == SIZE - 1) {
+        markDirty(getSectorKey(cx, cy + 1));
+    }
+    if (x % SIZE == 0) {
+        markDirty(getSectorKey(cx - 1, cy));
+    } else if (x % SIZE == SIZE - 1) {
+        markDirty(getSectorKey(cx + 1, cy));
+    }
+}
+
+void FlowFields::invalidateSector(const unsigned int x, const unsigned int y) {
+    markDirty(getSectorKey(x, y));
+    for (const sf::Vector2i& d : DIRECTIONS) {
+        markDirty(getSectorKey(x + d.x, y + d.y));
+    }
+}
+
+std::uint32_t FlowFields::getSectorKey(const unsigned int x,
+                                       const unsigned int y) {
+    if (x >= Map::CHUNK_NO || y >= Map::CHUNK_NO) {
+        return NO_SECTOR;
+    }
+
+    return y * Map::CHUNK_NO + x;
+}
+
+std::uint64_t FlowFields::getNodeKey(const std::uint32_t sector,
+                                     const std::size_t portal) {
+    return static_cast<std::uint64_t>(sector) << 8 | portal;
+}
+
+void FlowFields::markStale(Goal& g, const std::uint32_t key) {
+    if (key == NO_SECTOR) {
+        return;
+    }
+
+    const unsigned int x = key % Map::CHUNK_NO;
+    const unsigned int y = key / Map::CHUNK_NO;
+    for (const std::uint32_t k :
+         {key, getSectorKey(x, y - 1), getSectorKey(x, y + 1),
+          getSectorKey(x - 1, y), getSectorKey(x + 1, y)}) {
+        const auto it = g.fields.find(k);
+        if (it != g.fields.end()) {
+            it->second.stale = true;
+        }
+    }
+}
+
+void FlowFields::markDirty(const std::uint32_t key) {
+    const auto it = m_sectors.find(key);
+    if (it != m_sectors.end() && !it->second.dirty) {
+        it->second.dirty = true;
+        m_dirty.push_back(key);
+    }
+}
+
+void FlowFields::rebuildDirty() {
+    // Edits that leave the portal graph as it was keep every search
+    for (const std::uint32_t key : m_dirty) {
+        getSector(key);
+    }
+    m_dirty.clear();
+}
+
+FlowFields::Sector* FlowFields::getSector(const std::uint32_t key) {
+    auto it = m_sectors.find(key);
+    if (it == m_sectors.end()) {
+        if (key == NO_SECTOR ||
+            m_map.getChunk(key % Map::CHUNK_NO, key / Map::CHUNK_NO) ==
+                nullptr) {
+            return nullptr;
+        }
+        it = m_sectors.emplace(key, Sector()).first;
+    }
+
+    if (it->second.dirty) {
+        buildSector(key, it->second);
+    }
+    return &it->second;
+}
+
+std::uint64_t FlowFields::getAcross(const std::uint32_t key, const Sector& s,
+                                    const std::size_t portal) {
+    const Side side        = s.portals[portal].side;
+    const sf::Vector2i d   = DIRECTIONS[side];
+    const std::uint32_t nk = getSectorKey(key % Map::CHUNK_NO + d.x,
+                                          key / Map::CHUNK_NO + d.y);
+    const Sector* n        = getSector(nk);
+    if (n == nullptr) {
+        return NO_NODE;
+    }
+
+    // Both sides find the same runs in the same order
+    const unsigned int opposite = side ^ 1;
+    const std::size_t across =
+        n->sideStart[opposite] + (portal - s.sideStart[side]);
+    if (across >= n->sideStart[opposite + 1]) {
+        return NO_NODE;
+    }
+
+    return getNodeKey(nk, across);
+}
+
+void FlowFields::buildSector(const std::uint32_t key, Sector& s) {
+    NC_PROFILE_FUNCTION();
+    static Counter& built = Metrics::getCounter("path.sectors_built");
+    const unsigned int cx = key % Map::CHUNK_NO;
+    const unsigned int cy = key / Map::CHUNK_NO;
+    Chunk* c              = m_map.getChunk(cx, cy);
+
+    for (unsigned int y = 0; y < SIZE; y++) {
+        for (unsigned int x = 0; x < SIZE; x++) {
+            s.blocked[y * SIZE + x] = c->getTile(x, y).isCollidable();
+        }
+    }
+
+    // Portals are the walkable runs on both sides of every edge. The old
+    // graph is kept to tell whether searches over it went stale
+    m_portals.swap(s.portals);
+    m_distances.swap(s.distances);
+    s.portals.clear();
+    for (unsigned int side = 0; side < SIDE_NO; side++) {
+        s.sideStart[side]      = static_cast<std::uint8_t>(s.portals.size());
+        const sf::Vector2i d   = DIRECTIONS[side];
+        const std::uint32_t nk = getSectorKey(cx + d.x, cy + d.y);
+        Chunk* n               = nk == NO_SECTOR
+                                     ? nullptr
+                                     : m_map.getChunk(cx + d.x, cy + d.y);
+        if (n == nullptr) {
+            continue;
+        }
+
+        unsigned int start = SIZE;
+        for (unsigned int i = 0; i <= SIZE; i++) {
+            bool open = false;
+            if (i < SIZE) {
+                const std::uint16_t across = getEdgeTile(side ^ 1, i);
+                open = !s.blocked[getEdgeTile(side, i)] &&
+                       !n->getTile(across % SIZE, across / SIZE)
+                            .isCollidable();
+            }
+
+            if (open && start == SIZE) {
+                start = i;
+            } else if (!open && start != SIZE) {
+                Portal p;
+                p.first  = getEdgeTile(side, start);
+                p.center = getEdgeTile(side, (start + i - 1) / 2);
+                p.length = static_cast<std::uint8_t>(i - start);
+                p.side   = static_cast<Side>(side);
+                s.portals.push_back(p);
+                start = SIZE;
+            }
+        }
+    }
+    s.sideStart[SIDE_NO] = static_cast<std::uint8_t>(s.portals.size());
+
+    const std::size_t count = s.portals.size();
+    s.distances.assign(count * count, NO_DISTANCE);
+    for (std::size_t p = 0; p < count; p++) {
+        fillDistances(s, s.portals[p].center);
+        for (std::size_t q = 0; q < count; q++) {
+            const std::uint32_t d = m_costs[s.portals[q].center];
+            if (d != NO_COST) {
+                s.distances[p * count + q] = static_cast<std::uint16_t>(d);
+            }
+        }
+    }
+
+    if (s.portals != m_portals || s.distances != m_distances) {
+        m_graphVersion++;
+    }
+    s.generation++;
+    s.dirty = false;
+    built.add();
+}
+
+void FlowFields::fillDistances(const Sector& s, const std::uint16_t start) {
+    m_costs.assign(TILES, NO_COST);
+    m_queue.clear();
+    if (s.blocked[start]) {
+        return;
+    }
+
+    m_costs[start] = 0;
+    m_queue.push_back(start);
+    for (std::size_t i = 0; i < m_queue.size(); i++) {
+        const std::uint16_t t = m_queue[i];
+        forNeighbours(t, [&](const std::uint16_t n, unsigned int) {
+            if (!s.blocked[n] && m_costs[n] == NO_COST) {
+                m_costs[n] = m_costs[t] + 1;
+                m_queue.push_back(n);
+            }
+        });
+    }
+}
+
+void FlowFields::search(Goal& g) {
+    NC_PROFILE_FUNCTION();
+    static Counter& searches = Metrics::getCounter("path.searches");
+    searches.add();
+
+    // The goal tile seeds the fields of its old and new sector
+    markStale(g, g.sector);
+    g.sector       = getSectorKey(g.tile.x / SIZE, g.tile.y / SIZE);
+    g.searched = true;
+    markStale(g, g.sector);
+
+    // Sectors first reached by the search may bump the version on the way
+    m_previous.clear();
+    m_previous.swap(g.costs);
+    searchPortals(g);
+    g.graphVersion = m_graphVersion;
+
+    // A portal's cost seeds the field across it, so only fields next to a
+    // changed cost can have gone stale
+    for (const auto& [node, cost] : g.costs) {
+        const auto it = m_previous.find(node);
+        if (it == m_previous.end() || it->second != cost) {
+            markStale(g, static_cast<std::uint32_t>(node >> 8));
+        }
+    }
+    for (const auto& entry : m_previous) {
+        if (g.costs.count(entry.first) == 0) {
+            markStale(g, static_cast<std::uint32_t>(entry.first >> 8));
+        }
+    }
+}
+
+void FlowFields::searchPortals(Goal& g) {
+    const std::uint32_t goalKey = g.sector;
+    const Sector* gs            = getSector(goalKey);
+    if (gs == nullptr) {
+        return;
+    }
+    g.generation = gs->generation;
+
+    using Entry = std::pair<std::uint32_t, std::uint64_t>;
+    MinQueue<Entry> queue;
+    const auto relax = [&](const std::uint64_t node, const std::uint32_t cost) {
+        const auto [it, inserted] = g.costs.try_emplace(node, cost);
+        if (!inserted) {
+            if (cost >= it->second) {
+                return;
+            }
+            it->second = cost;
+        }
+        queue.emplace(cost, node);
+    };
+
+    fillDistances(*gs, static_cast<std::uint16_t>((g.tile.y % SIZE) * SIZE +
+                                                  g.tile.x % SIZE));
+    for (std::size_t p = 0; p < gs->portals.size(); p++) {
+        const std::uint32_t cost = m_costs[gs->portals[p].center];
+        if (cost != NO_COST) {
+            relax(getNodeKey(goalKey, p), cost);
+        }
+    }
+
+    while (!queue.empty()) {
+        const auto [cost, node] = queue.top();
+        queue.pop();
+        if (cost > g.costs[node]) {
+            continue;
+        }
+
+        const auto key             = static_cast<std::uint32_t>(node >> 8);
+        const std::size_t p        = node & MAX_PORTAL_INDEX;
+        const Sector* s            = getSector(key);
+        const std::uint64_t across = getAcross(key, *s, p);
+        if (across != NO_NODE) {
+            relax(across, cost + 1);
+        }
+
+        const std::size_t count = s->portals.size();
+        for (std::size_t q = 0; q < count; q++) {
+            const std::uint16_t d = s->distances[p * count + q];
+            if (q != p && d != NO_DISTANCE) {
+                relax(getNodeKey(key, q), cost + d);
+            }
+        }
+    }
+}
+
+const FlowFields::SectorField* FlowFields::getField(Goal& g,
+                                                    const std::uint32_t key) {
+    const Sector* s = getSector(key);
+    if (s == nullptr) {
+        return nullptr;
+    }
+
+    const auto [it, inserted] = g.fields.try_emplace(key);
+    SectorField& f            = it->second;
+    if (!inserted && !f.stale && f.generation == s->generation) {
+        return &f;
+    }
+
+    // Only rebuilt if a tile or the cost past one of its portals changed
+    m_seeds.clear();
+    m_seeds.push_back(getSectorKey(g.tile.x / SIZE, g.tile.y / SIZE) == key
+                          ? (g.tile.y % SIZE) * SIZE + g.tile.x % SIZE
+                          : NO_COST);
+    for (std::size_t p = 0; p < s->portals.size(); p++) {
+        const std::uint64_t across = getAcross(key, *s, p);
+        const auto cost            = g.costs.find(across);
+        m_seeds.push_back(cost == g.costs.end() ? NO_COST : cost->second + 1);
+    }
+
+    if (inserted || f.generation != s->generation || f.seeds != m_seeds) {
+        f.seeds      = m_seeds;
+        f.generation = s->generation;
+        buildField(*s, f.seeds, f);
+    }
+    f.stale = false;
+    return &f;
+}
+
+void FlowFields::buildField(const Sector& s,
+                            const std::vector<std::uint32_t>& seeds,
+                            SectorField& f) {
+    NC_PROFILE_FUNCTION();
+    static Counter& built = Metrics::getCounter("path.fields_built");
+    built.add();
+
+    m_costs.assign(TILES, NO_COST);
+    m_via.assign(TILES, NO_SIDE);
+    using Entry = std::pair<std::uint32_t, std::uint16_t>;
+    MinQueue<Entry> queue;
+
+    if (seeds[0] != NO_COST && !s.blocked[seeds[0]]) {
+        m_costs[seeds[0]] = 0;
+        queue.emplace(0, static_cast<std::uint16_t>(seeds[0]));
+    }
+
+    // Tiles along a portal leave through it, paying the walk to its center
+    // on the other side
+    for (std::size_t p = 0; p < s.portals.size(); p++) {
+        const std::uint32_t seed = seeds[p + 1];
+        if (seed == NO_COST) {
+            continue;
+        }
+
+        const Portal& portal    = s.portals[p];
+        const unsigned int step = portal.side <= Bottom ? 1 : SIZE;
+        const int center        = (portal.center - portal.first) / step;
+        for (unsigned int i = 0; i < portal.length; i++) {
+            const auto t = static_cast<std::uint16_t>(portal.first + i * step);
+            const std::uint32_t cost =
+                seed + static_cast<std::uint32_t>(
+                           std::abs(static_cast<int>(i) - center));
+            if (cost < m_costs[t]) {
+                m_costs[t] = cost;
+                m_via[t]   = portal.side;
+                queue.emplace(cost, t);
+            }
+        }
+    }
+
+    while (!queue.empty()) {
+        const auto [cost, t] = queue.top();
+        queue.pop();
+        if (cost > m_costs[t]) {
+            continue;
+        }
+
+        forNeighbours(t, [&](const std::uint16_t n, unsigned int) {
+            if (!s.blocked[n] && cost + 1 < m_costs[n]) {
+                m_costs[n] = cost + 1;
+                m_via[n]   = NO_SIDE;
+                queue.emplace(cost + 1, n);
+            }
+        });
+    }
+
+    // Each tile points at its cheapest neighbour, or out of the sector
+    for (std::uint16_t t = 0; t < TILES; t++) {
+        f.directions[t] = 0;
+        if (m_costs[t] == NO_COST) {
+            continue;
+        }
+
+        if (m_via[t] != NO_SIDE) {
+            f.directions[t] = static_cast<std::uint8_t>(m_via[t] + 1);
+            continue;
+        }
+
+        std::uint32_t best = m_costs[t];
+        forNeighbours(t, [&](const std::uint16_t n, const unsigned int code) {
+            if (m_costs[n] < best) {
+                best            = m_costs[n];
+                f.directions[t] = static_cast<std::uint8_t>(code);
+            }
+        });
+    }
+}
+
+}
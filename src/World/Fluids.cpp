@@ -0,0 +1,464 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <World/Fluids.hpp>
+#include <World/Map.hpp>
+#include <Game/Game.hpp>
+#include <General/TextureAtlas.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+
+namespace {
+
+enum Direction { Up, Down, Left, Right };
+
+constexpr int xDir[]           = {0, 0, -1, 1};
+constexpr int yDir[]           = {-1, 1, 0, 0};
+constexpr Direction opposite[] = {Down, Up, Right, Left};
+
+}
+
+namespace nc {
+
+Fluids::Fluids(Map& map)
+    : m_map(map), m_render(!Game::getInstance()->isHeadless()),
+      m_parallel(true) {}
+
+void Fluids::placeSource(const unsigned int x, const unsigned int y,
+                         const Fluid fluid) {
+    FluidChunk* fc           = getChunk(x / SIZE, y / SIZE);
+    const unsigned int index = (y % SIZE) * SIZE + x % SIZE;
+    if (fc == nullptr || fc->solid[index] || fluid == Fluid::None) {
+        return;
+    }
+
+    setCell(*fc, index, Cell{fluid, MAX_LEVEL, true});
+    activateAround(x, y, true);
+}
+
+void Fluids::remove(const unsigned int x, const unsigned int y) {
+    FluidChunk* fc = findChunk(x / SIZE, y / SIZE);
+    if (fc == nullptr) {
+        return;
+    }
+
+    const unsigned int index = (y % SIZE) * SIZE + x % SIZE;
+    setCell(*fc, index, Cell());
+    activate(*fc, index);
+    activateAround(x, y, false);
+}
+
+Fluid Fluids::getFluid(const unsigned int x, const unsigned int y) const {
+    const Cell* c = findCell(x, y);
+    return c == nullptr ? Fluid::None : c->fluid;
+}
+
+std::uint8_t Fluids::getLevel(const unsigned int x,
+                              const unsigned int y) const {
+    const Cell* c = findCell(x, y);
+    return c == nullptr ? 0 : c->level;
+}
+
+void Fluids::invalidateTile(const unsigned int x, const unsigned int y) {
+    const Tile* tile = m_map.getTile(x, y);
+    const bool solid = tile != nullptr && tile->isCollidable();
+
+    if (FluidChunk* fc = findChunk(x / SIZE, y / SIZE); fc != nullptr) {
+        const unsigned int index = (y % SIZE) * SIZE + x % SIZE;
+        fc->solid[index]         = solid;
+        if (solid) {
+            if (fc->cells[getPadded(index)].level != 0) {
+                setCell(*fc, index, Cell());
+                activateAround(x, y, false);
+            }
+            return;
+        }
+    } else if (solid) {
+        return;
+    }
+
+    // An opened tile fills from its neighbours
+    bool wet = false;
+    for (unsigned int d = 0; d < 4; d++) {
+        wet |= getLevel(x + xDir[d], y + yDir[d]) != 0;
+    }
+    activate(x, y, wet);
+}
+
+void Fluids::invalidateChunk(const unsigned int x, const unsigned int y) {
+    const unsigned int x0 = x * SIZE;
+    const unsigned int y0 = y * SIZE;
+
+    // Wraps around below 0, where no chunk is found
+    for (unsigned int i = 0; i < SIZE; i++) {
+        if (getLevel(x0 + i, y0 - 1) != 0) {
+            activate(x0 + i, y0, true);
+        }
+        if (getLevel(x0 + i, y0 + SIZE) != 0) {
+            activate(x0 + i, y0 + SIZE - 1, true);
+        }
+        if (getLevel(x0 - 1, y0 + i) != 0) {
+            activate(x0, y0 + i, true);
+        }
+        if (getLevel(x0 + SIZE, y0 + i) != 0) {
+            activate(x0 + SIZE - 1, y0 + i, true);
+        }
+    }
+}
+
+void Fluids::setParallel(const bool parallel) {
+    m_parallel = parallel;
+}
+
+bool Fluids::isAsleep() const {
+    return m_awake.empty();
+}
+
+std::size_t Fluids::getAwakeChunkNo() const {
+    return m_awake.size();
+}
+
+void Fluids::update() {
+    NC_PROFILE_FUNCTION();
+    static Gauge& chunks       = Metrics::getGauge("fluids.chunks");
+    static Gauge& awake        = Metrics::getGauge("fluids.awake_chunks");
+    static Counter& updates    = Metrics::getCounter("fluids.cell_updates");
+    static Histogram& stepTime = Metrics::getHistogram("fluids.step_time");
+
+    chunks.set(static_cast<std::int64_t>(m_chunks.size()));
+    awake.set(static_cast<std::int64_t>(m_awake.size()));
+    if (m_awake.empty()) {
+        return;
+    }
+    sf::Clock clock;
+
+    // Every step reads the state the tick started with, so the borders are
+    // copied before any chunk changes
+    m_stepping = m_awake;
+    for (FluidChunk* fc : m_stepping) {
+        exchangeHalo(*fc);
+    }
+
+    ThreadPool& pool    = Game::getInstance()->getThreadPool();
+    const std::size_t n = m_stepping.size();
+    if (!m_parallel || n < PARALLEL_MIN_CHUNKS || pool.getThreadNo() == 0) {
+        for (FluidChunk* fc : m_stepping) {
+            step(*fc);
+        }
+    } else {
+        // One batch stays on this thread
+        const std::size_t batches =
+            std::min<std::size_t>(pool.getThreadNo() + 1, n);
+        for (std::size_t b = 1; b < batches; b++) {
+            m_jobs.push_back(pool.submit([this, b, batches, n]() {
+                for (std::size_t i = b * n / batches;
+                     i < (b + 1) * n / batches; i++) {
+                    step(*m_stepping[i]);
+                }
+            }));
+        }
+        for (std::size_t i = 0; i < n / batches; i++) {
+            step(*m_stepping[i]);
+        }
+        for (std::future<void>& job : m_jobs) {
+            job.get();
+        }
+        m_jobs.clear();
+    }
+
+    // Chunks are only redrawn when a level that's drawn differently changed
+    std::size_t updated = 0;
+    for (FluidChunk* fc : m_stepping) {
+        updated += fc->updated;
+        if (fc->visibleChange) {
+            fc->chunk->setDirty();
+        }
+        for (const Wake& w : fc->outbox) {
+            activate(w.x, w.y, w.create);
+        }
+    }
+
+    m_awake.erase(std::remove_if(m_awake.begin(), m_awake.end(),
+                                 [](FluidChunk* fc) {
+                                     fc->awake = !fc->active.empty();
+                                     return !fc->awake;
+                                 }),
+                  m_awake.end());
+
+    updates.add(updated);
+    stepTime.record(clock.getElapsedTime().asSeconds());
+}
+
+std::uint32_t Fluids::getKey(const unsigned int x, const unsigned int y) {
+    return y << 16 | x;
+}
+
+unsigned int Fluids::getPadded(const unsigned int index) {
+    return (index / SIZE + 1) * PADDED + index % SIZE + 1;
+}
+
+std::uint8_t Fluids::getVisualLevel(const Cell& cell) {
+    return static_cast<std::uint8_t>(
+        (cell.level * VISUAL_LEVELS + MAX_LEVEL - 1) / MAX_LEVEL);
+}
+
+bool Fluids::isDrawnDifferently(const Cell& a, const Cell& b) {
+    return a.fluid != b.fluid || getVisualLevel(a) != getVisualLevel(b);
+}
+
+Fluids::FluidChunk* Fluids::findChunk(const unsigned int x,
+                                      const unsigned int y) const {
+    if (x >= Map::CHUNK_NO || y >= Map::CHUNK_NO) {
+        return nullptr;
+    }
+
+    const auto it = m_chunks.find(getKey(x, y));
+    return it == m_chunks.end() ? nullptr : it->second.get();
+}
+
+Fluids::FluidChunk* Fluids::getChunk(const unsigned int x,
+                                     const unsigned int y) {
+    if (FluidChunk* fc = findChunk(x, y); fc != nullptr) {
+        return fc;
+    }
+
+    // Fluid stops at the edge of the generated world
+    Chunk* chunk = x < Map::CHUNK_NO && y < Map::CHUNK_NO
+                       ? m_map.getChunk(x, y)
+                       : nullptr;
+    if (chunk == nullptr) {
+        return nullptr;
+    }
+
+    auto fc           = std::make_unique<FluidChunk>();
+    fc->x             = x;
+    fc->y             = y;
+    fc->chunk         = chunk;
+    fc->updated       = 0;
+    fc->awake         = false;
+    fc->visibleChange = false;
+    for (unsigned int ty = 0; ty < SIZE; ty++) {
+        for (unsigned int tx = 0; tx < SIZE; tx++) {
+            fc->solid[ty * SIZE + tx] = chunk->getTile(tx, ty).isCollidable();
+        }
+    }
+
+    for (unsigned int d = 0; d < 4; d++) {
+        FluidChunk* n     = findChunk(x + xDir[d], y + yDir[d]);
+        fc->neighbours[d] = n;
+        if (n != nullptr) {
+            n->neighbours[opposite[d]] = fc.get();
+        }
+    }
+
+    if (m_render) {
+        constexpr auto tile = static_cast<float>(TextureAtlas::TILE_SIZE);
+        fc->overlay         = std::make_unique<sf::VertexArray>(
+            sf::Quads, SIZE * SIZE * 4);
+        for (unsigned int i = 0; i < SIZE * SIZE; i++) {
+            const sf::Vector2f pos(static_cast<float>(i % SIZE) * tile,
+                                   static_cast<float>(i / SIZE) * tile);
+            sf::VertexArray& quads    = *fc->overlay;
+            quads[i * 4 + 0].position = pos;
+            quads[i * 4 + 1].position = pos + sf::Vector2f(tile, 0.0f);
+            quads[i * 4 + 2].position = pos + sf::Vector2f(tile, tile);
+            quads[i * 4 + 3].position = pos + sf::Vector2f(0.0f, tile);
+            for (unsigned int v = 0; v < 4; v++) {
+                quads[i * 4 + v].color = sf::Color::Transparent;
+            }
+        }
+        chunk->setOverlay(fc->overlay.get());
+    }
+
+    FluidChunk* result = fc.get();
+    m_chunks.emplace(getKey(x, y), std::move(fc));
+    return result;
+}
+
+const Fluids::Cell* Fluids::findCell(const unsigned int x,
+                                     const unsigned int y) const {
+    const FluidChunk* fc = findChunk(x / SIZE, y / SIZE);
+    return fc == nullptr
+               ? nullptr
+               : &fc->cells[getPadded((y % SIZE) * SIZE + x % SIZE)];
+}
+
+void Fluids::activate(const unsigned int x, const unsigned int y,
+                      const bool create) {
+    FluidChunk* fc =
+        create ? getChunk(x / SIZE, y / SIZE) : findChunk(x / SIZE, y / SIZE);
+    if (fc != nullptr) {
+        activate(*fc, (y % SIZE) * SIZE + x % SIZE);
+    }
+}
+
+void Fluids::activateAround(const unsigned int x, const unsigned int y,
+                            const bool create) {
+    for (unsigned int d = 0; d < 4; d++) {
+        activate(x + xDir[d], y + yDir[d], create);
+    }
+}
+
+void Fluids::activate(FluidChunk& fc, const unsigned int index) {
+    if (!fc.queued[index]) {
+        fc.queued.set(index);
+        fc.active.push_back(static_cast<std::uint16_t>(index));
+    }
+
+    if (!fc.awake) {
+        fc.awake = true;
+        m_awake.push_back(&fc);
+    }
+}
+
+void Fluids::setCell(FluidChunk& fc, const unsigned int index,
+                     const Cell& cell) {
+    Cell& c           = fc.cells[getPadded(index)];
+    const bool redraw = isDrawnDifferently(c, cell);
+    c                 = cell;
+    if (redraw) {
+        drawCell(fc, index);
+        fc.chunk->setDirty();
+    }
+}
+
+void Fluids::exchangeHalo(FluidChunk& fc) {
+    const FluidChunk* up    = fc.neighbours[Up];
+    const FluidChunk* down  = fc.neighbours[Down];
+    const FluidChunk* left  = fc.neighbours[Left];
+    const FluidChunk* right = fc.neighbours[Right];
+
+    for (unsigned int i = 1; i <= SIZE; i++) {
+        fc.cells[i] = up != nullptr ? up->cells[SIZE * PADDED + i] : Cell();
+        fc.cells[(SIZE + 1) * PADDED + i] =
+            down != nullptr ? down->cells[PADDED + i] : Cell();
+        fc.cells[i * PADDED] =
+            left != nullptr ? left->cells[i * PADDED + SIZE] : Cell();
+        fc.cells[i * PADDED + SIZE + 1] =
+            right != nullptr ? right->cells[i * PADDED + 1] : Cell();
+    }
+}
+
+void Fluids::step(FluidChunk& fc) const {
+    fc.stepping.swap(fc.active);
+    fc.active.clear();
+    fc.queued.reset();
+    fc.changes.clear();
+    fc.outbox.clear();
+    fc.updated       = fc.stepping.size();
+    fc.visibleChange = false;
+
+    // Every cell is computed before any changes, as if all at once
+    for (const std::uint16_t i : fc.stepping) {
+        const Cell cell = computeCell(fc, i);
+        if (cell != fc.cells[getPadded(i)]) {
+            fc.changes.emplace_back(i, cell);
+        }
+    }
+
+    const auto queue = [&fc](const unsigned int i) {
+        if (!fc.queued[i]) {
+            fc.queued.set(i);
+            fc.active.push_back(static_cast<std::uint16_t>(i));
+        }
+    };
+
+    for (const auto& [i, cell] : fc.changes) {
+        Cell& c           = fc.cells[getPadded(i)];
+        const bool redraw = isDrawnDifferently(c, cell);
+        c                 = cell;
+        if (redraw) {
+            drawCell(fc, i);
+            fc.visibleChange = true;
+        }
+
+        // The neighbours depend on the cell, across the border too
+        const unsigned int x  = i % SIZE;
+        const unsigned int y  = i / SIZE;
+        const unsigned int gx = fc.x * SIZE + x;
+        const unsigned int gy = fc.y * SIZE + y;
+        const bool wet        = cell.level != 0;
+        if (y > 0) {
+            queue(i - SIZE);
+        } else if (fc.y > 0) {
+            fc.outbox.push_back({gx, gy - 1, wet});
+        }
+        if (y < SIZE - 1) {
+            queue(i + SIZE);
+        } else {
+            fc.outbox.push_back({gx, gy + 1, wet});
+        }
+        if (x > 0) {
+            queue(i - 1);
+        } else if (fc.x > 0) {
+            fc.outbox.push_back({gx - 1, gy, wet});
+        }
+        if (x < SIZE - 1) {
+            queue(i + 1);
+        } else {
+            fc.outbox.push_back({gx + 1, gy, wet});
+        }
+    }
+}
+
+Fluids::Cell Fluids::computeCell(const FluidChunk& fc,
+                                 const unsigned int index) const {
+    const unsigned int p = getPadded(index);
+    if (fc.solid[index]) {
+        return Cell();
+    }
+    if (fc.cells[p].source) {
+        return fc.cells[p];
+    }
+
+    // Fed by the highest neighbour, lava wins ties
+    const Cell* best = &fc.cells[p - PADDED];
+    for (const unsigned int n : {p + PADDED, p - 1, p + 1}) {
+        const Cell& c = fc.cells[n];
+        if (c.level > best->level ||
+            (c.level == best->level && c.fluid > best->fluid)) {
+            best = &c;
+        }
+    }
+
+    const std::uint8_t decay = DECAY[static_cast<std::uint8_t>(best->fluid)];
+    if (best->level <= decay) {
+        return Cell();
+    }
+    return Cell{best->fluid, static_cast<std::uint8_t>(best->level - decay),
+                false};
+}
+
+void Fluids::drawCell(FluidChunk& fc, const unsigned int index) const {
+    if (fc.overlay == nullptr) {
+        return;
+    }
+
+    const Cell& cell          = fc.cells[getPadded(index)];
+    const std::uint8_t visual = getVisualLevel(cell);
+    sf::Color color           = cell.fluid == Fluid::Lava
+                                    ? sf::Color(230, 90, 20)
+                                    : sf::Color(40, 100, 220);
+
+    // Deeper fluid is drawn more opaque
+    color.a = visual == 0 ? 0 : static_cast<sf::Uint8>(70 + 45 * visual);
+
+    for (unsigned int v = 0; v < 4; v++) {
+        (*fc.overlay)[index * 4 + v].color = color;
+    }
+}
+
+}
@@ -0,0 +1,230 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <World/ItemDrops.hpp>
+#include <Components/DroppedItemComponent.hpp>
+#include <Components/InventoryComponent.hpp>
+#include <Components/CollisionBoxComponent.hpp>
+#include <Components/PlayerComponent.hpp>
+#include <General/Object.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+static_assert(nc::ItemDrops::PICKUP_RADIUS <= nc::ItemDrops::MERGE_RADIUS,
+              "Pickups only look at the neighbouring cells");
+static_assert(nc::ItemDrops::PICKUP_DELAY >= nc::ItemDrops::MERGE_INTERVAL,
+              "Stacks must be in the cells by the time they can be picked up");
+
+int getCellCoord(const float pos) {
+    return static_cast<int>(std::floor(pos / nc::ItemDrops::MERGE_RADIUS));
+}
+
+float getDistanceSq(const sf::Vector2f a, const sf::Vector2f b) {
+    const sf::Vector2f d = a - b;
+    return d.x * d.x + d.y * d.y;
+}
+
+}
+
+namespace nc {
+
+ItemDrops::ItemDrops() = default;
+
+entt::entity ItemDrops::drop(entt::registry& reg, const ItemStack& stack,
+                             const sf::Vector2f pos) {
+    if (stack.isEmpty()) {
+        return entt::null;
+    }
+
+    const std::uint64_t tick = m_despawn.getTick();
+    const entt::entity e     = reg.create();
+    reg.emplace<DroppedItemComponent>(
+        e, DroppedItemComponent{stack, pos, tick + DESPAWN_TICKS,
+                                tick + PICKUP_DELAY});
+    m_despawn.schedule(DESPAWN_TICKS, e);
+    return e;
+}
+
+void ItemDrops::update(entt::registry& reg) {
+    NC_PROFILE_FUNCTION();
+    static Counter& despawned = Metrics::getCounter("items.despawned");
+    static Gauge& stacks      = Metrics::getGauge("items.stacks");
+
+    m_despawn.advance([&](const entt::entity e) {
+        // Merges push the despawn back by scheduling a new timer, the old
+        // one no longer matches
+        if (!reg.valid(e)) {
+            return;
+        }
+        const auto* item = reg.try_get<DroppedItemComponent>(e);
+        if (item != nullptr && item->despawnTick == m_despawn.getTick()) {
+            reg.destroy(e);
+            despawned.add();
+        }
+    });
+
+    // Stacks never move, so the cells stay valid between passes apart from
+    // the stacks dropped since
+    if (m_despawn.getTick() % MERGE_INTERVAL == 0) {
+        buildCells(reg);
+        merge(reg);
+    }
+    pickUp(reg);
+
+    stacks.set(static_cast<std::int64_t>(
+        reg.view<DroppedItemComponent>().size()));
+}
+
+void ItemDrops::draw(entt::registry& reg, sf::RenderTarget& target,
+                     const sf::FloatRect& area) const {
+    reg.view<const DroppedItemComponent>().each([&](const auto& item) {
+        if (item.stack.isEmpty() || !area.contains(item.pos)) {
+            return;
+        }
+
+        sf::Sprite sprite(item.stack.getItem()->getSprite());
+        sprite.scale(DRAW_SIZE, DRAW_SIZE);
+        sprite.setPosition(item.pos -
+                           sf::Vector2f(DRAW_SIZE / 2.0f, DRAW_SIZE / 2.0f));
+        target.draw(sprite);
+    });
+}
+
+std::uint64_t ItemDrops::getCellKey(const int x, const int y) {
+    // Rows first, so the cells of a row next to each other are contiguous
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) << 32 |
+           static_cast<std::uint32_t>(x);
+}
+
+void ItemDrops::buildCells(entt::registry& reg) {
+    m_cells.clear();
+    reg.view<const DroppedItemComponent>().each(
+        [this](const auto e, const auto& item) {
+            m_cells.emplace_back(getCellKey(getCellCoord(item.pos.x),
+                                            getCellCoord(item.pos.y)),
+                                 e);
+        });
+    std::sort(m_cells.begin(), m_cells.end());
+}
+
+template <typename F>
+void ItemDrops::forEachNear(const sf::Vector2f pos, F&& f) const {
+    // World positions are never negative
+    const int x = getCellCoord(pos.x);
+    const int y = getCellCoord(pos.y);
+
+    for (int row = std::max(y - 1, 0); row <= y + 1; row++) {
+        auto it = std::lower_bound(
+            m_cells.begin(), m_cells.end(),
+            Cell(getCellKey(std::max(x - 1, 0), row), entt::entity{0}));
+        const std::uint64_t last = getCellKey(x + 1, row);
+        for (; it != m_cells.end() && it->first <= last; it++) {
+            f(it->second);
+        }
+    }
+}
+
+void ItemDrops::merge(entt::registry& reg) {
+    NC_PROFILE_FUNCTION();
+    static Counter& merged = Metrics::getCounter("items.merged");
+    const std::uint64_t tick = m_despawn.getTick();
+
+    for (const Cell& cell : m_cells) {
+        auto& into = reg.get<DroppedItemComponent>(cell.second);
+        if (into.stack.isEmpty()) {
+            continue;
+        }
+
+        forEachNear(into.pos, [&](const entt::entity e) {
+            auto& from = reg.get<DroppedItemComponent>(e);
+            if (e == cell.second || from.stack.isEmpty() ||
+                from.stack.getItem() != into.stack.getItem() ||
+                getDistanceSq(from.pos, into.pos) >
+                    MERGE_RADIUS * MERGE_RADIUS) {
+                return;
+            }
+
+            const unsigned int moved =
+                std::min(from.stack.getCount(),
+                         ItemStack::MAX_COUNT - into.stack.getCount());
+            if (moved == 0) {
+                return;
+            }
+            into.stack.setCount(into.stack.getCount() + moved);
+            from.stack.setCount(from.stack.getCount() - moved);
+            if (!from.stack.isEmpty()) {
+                return;
+            }
+
+            // The merged stack lasts as long as the longest lived part
+            m_dead.push_back(e);
+            merged.add();
+            if (from.despawnTick > into.despawnTick) {
+                into.despawnTick = from.despawnTick;
+                m_despawn.schedule(into.despawnTick - tick, cell.second);
+            }
+            into.pickupTick = std::max(into.pickupTick, from.pickupTick);
+        });
+    }
+
+    reg.destroy(m_dead.begin(), m_dead.end());
+    m_dead.clear();
+}
+
+void ItemDrops::pickUp(entt::registry& reg) {
+    NC_PROFILE_FUNCTION();
+    static Counter& pickedUp = Metrics::getCounter("items.picked_up");
+    const std::uint64_t tick = m_despawn.getTick();
+
+    reg.view<PlayerComponent, InventoryComponent, Object>().each(
+        [&](const auto p, auto& inv, auto& obj) {
+            sf::Vector2f feet = obj.getPosition();
+            if (const auto* cb = reg.try_get<CollisionBoxComponent>(p);
+                cb != nullptr) {
+                feet = sf::Vector2f(cb->box.left + cb->box.width / 2.0f,
+                                    cb->box.top + cb->box.height / 2.0f);
+            }
+
+            forEachNear(feet, [&](const entt::entity e) {
+                // Stacks merged or despawned since the last pass
+                if (!reg.valid(e)) {
+                    return;
+                }
+                auto& item = reg.get<DroppedItemComponent>(e);
+                if (item.stack.isEmpty() || tick < item.pickupTick ||
+                    getDistanceSq(item.pos, feet) >
+                        PICKUP_RADIUS * PICKUP_RADIUS) {
+                    return;
+                }
+
+                const unsigned int taken =
+                    inv.insert(item.stack.getItem(), item.stack.getCount());
+                item.stack.setCount(item.stack.getCount() - taken);
+                if (item.stack.isEmpty()) {
+                    m_dead.push_back(e);
+                    pickedUp.add();
+                }
+            });
+        });
+
+    reg.destroy(m_dead.begin(), m_dead.end());
+    m_dead.clear();
+}
+
+}
@@ -14,10 +14,37 @@
 
 #include <World/Map.hpp>
 #include <Components/PlayerComponent.hpp>
-#include <Components/AnimationComponent.hpp>
+#include <Components/SteeringComponent.hpp>
+#include <Components/VelocityComponent.hpp>
+#include <Components/CollisionBoxComponent.hpp>
+#include <Components/LodComponent.hpp>
+#include <General/AnimationSystem.hpp>
 #include <General/Object.hpp>
+#include <Game/Game.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <SFML/System/Clock.hpp>
+#include <spdlog/spdlog.h>
 #include <random>
 #include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Tile an entity stands on, its collision box if it has one
+sf::Vector2f getFootPosition(entt::registry& reg, const entt::entity e,
+                             const nc::Object& obj) {
+    if (const auto* cb = reg.try_get<nc::CollisionBoxComponent>(e);
+        cb != nullptr) {
+        return sf::Vector2f(cb->box.left + cb->box.width / 2.0f,
+                            cb->box.top + cb->box.height / 2.0f);
+    }
+
+    return obj.getPosition();
+}
+
+}
 
 namespace nc {
 
@@ -49,29 +76,33 @@ sf::Vector2f Map::getGlobalPos(sf::Vector2u chunkPos, sf::Vector2u tilePos) {
     return getGlobalPos(chunkPos.x, chunkPos.y, tilePos.x, tilePos.y);
 }
 
-Map::Map(Generator* gen) : m_gen(gen) {
-    m_chunks = new Chunk**[CHUNK_NO];
-    for (unsigned int y = 0; y < CHUNK_NO; y++) {
-        m_chunks[y] = new Chunk*[CHUNK_NO];
-        for (unsigned int x = 0; x < CHUNK_NO; x++) {
-            m_chunks[y][x] = nullptr;
-        }
+Map::Map(Generator* gen)
+    : m_arena(sizeof(Chunk) * ARENA_BLOCK_CHUNKS), m_gen(gen), m_flow(*this),
+      m_ticks(*this), m_fluids(*this) {
+    m_pages.fill(nullptr);
+    if (m_gen != nullptr) {
+        m_ticks.setSeed(m_gen->getSeed());
     }
 }
 
 Map::~Map() {
-    for (unsigned int y = 0; y < CHUNK_NO; y++) {
-        for (unsigned int x = 0; x < CHUNK_NO; x++) {
-            delete m_chunks[y][x];
-        }
-        delete[] m_chunks[y];
-    }
+    static Gauge& resident = Metrics::getGauge("map.chunks_resident");
+    static Gauge& arena    = Metrics::getGauge("map.arena_bytes");
 
-    delete[] m_chunks;
+    // Chunks hold render textures and have to be destroyed, their memory
+    // and the pages go back with the arena
+    for (Chunk* c : m_loaded) {
+        c->~Chunk();
+    }
+    resident.add(-static_cast<std::int64_t>(m_loaded.size()));
+    arena.add(-static_cast<std::int64_t>(m_arena.getReserved()));
 }
 
 void Map::setGenerator(Generator* gen) {
     m_gen = gen;
+    if (m_gen != nullptr) {
+        m_ticks.setSeed(m_gen->getSeed());
+    }
 }
 
 Generator* Map::getGenerator() const {
@@ -79,7 +110,14 @@ Generator* Map::getGenerator() const {
 }
 
 Chunk* Map::getChunk(const unsigned int x, const unsigned int y) {
-    return m_chunks[y][x];
+    if (x >= CHUNK_NO || y >= CHUNK_NO) {
+        return nullptr;
+    }
+
+    const Page* page = m_pages[(y / PAGE_SIZE) * PAGE_NO + x / PAGE_SIZE];
+    return page == nullptr
+               ? nullptr
+               : (*page)[(y % PAGE_SIZE) * PAGE_SIZE + x % PAGE_SIZE];
 }
 
 Chunk* Map::getChunk(const sf::Vector2u pos) {
@@ -87,9 +125,29 @@ Chunk* Map::getChunk(const sf::Vector2u pos) {
 }
 
 void Map::generateChunk(unsigned int x, unsigned int y) {
-    m_chunks[y][x] = new Chunk(x, y);
+    NC_PROFILE_SCOPE("Map::generateChunk");
+    static Counter& generated = Metrics::getCounter("map.chunks_generated");
+    static Gauge& resident    = Metrics::getGauge("map.chunks_resident");
+    static Histogram& genTime =
+        Metrics::getHistogram("map.chunk_generation_time");
+    static Gauge& arena = Metrics::getGauge("map.arena_bytes");
+    sf::Clock genClock;
+
+    const std::size_t reserved = m_arena.getReserved();
+    Page*& page = m_pages[(y / PAGE_SIZE) * PAGE_NO + x / PAGE_SIZE];
+    if (page == nullptr) {
+        page = m_arena.create<Page>();
+        page->fill(nullptr);
+    }
+
+    Chunk* chunk = m_arena.create<Chunk>(x, y);
+    (*page)[(y % PAGE_SIZE) * PAGE_SIZE + x % PAGE_SIZE] = chunk;
+    arena.add(static_cast<std::int64_t>(m_arena.getReserved() - reserved));
+    m_loaded.push_back(chunk);
+    generated.add();
+    resident.add(1);
     if (m_gen != nullptr) {
-        m_gen->generateChunk(m_chunks[y][x]);
+        m_gen->generateChunk(chunk);
         for (unsigned int tileY = 0; tileY < Chunk::CHUNK_SIZE; tileY++) {
             for (unsigned int tileX = 0; tileX < Chunk::CHUNK_SIZE; tileX++) {
                 updateTile(x * Chunk::CHUNK_SIZE + tileX,
@@ -162,17 +220,53 @@ void Map::generateChunk(unsigned int x, unsigned int y) {
             }
         }
     }
+
+    // Neighbours gain portals toward the new chunk
+    m_flow.invalidateSector(x, y);
+    m_fluids.invalidateChunk(x, y);
+    genTime.record(genClock.getElapsedTime().asSeconds());
 }
 
 void Map::generateChunk(const sf::Vector2u pos) {
     generateChunk(pos.x, pos.y);
 }
 
+const std::vector<Chunk*>& Map::getLoadedChunks() const {
+    return m_loaded;
+}
+
 entt::registry& Map::getRegistry() {
     return m_reg;
 }
 
+SimulationLod& Map::getLod() {
+    return m_lod;
+}
+
+FlowFields& Map::getFlowFields() {
+    return m_flow;
+}
+
+ItemDrops& Map::getItemDrops() {
+    return m_items;
+}
+
+TileTicks& Map::getTileTicks() {
+    return m_ticks;
+}
+
+Fluids& Map::getFluids() {
+    return m_fluids;
+}
+
 void Map::simulateWorld(const float dt) {
+    NC_PROFILE_SCOPE("Map::simulateWorld");
+    static Counter& tileUpdates = Metrics::getCounter("map.tile_updates");
+    static Gauge& tickUpdates   =
+        Metrics::getGauge("map.tile_updates_per_tick");
+    const std::uint64_t updatesBefore = tileUpdates.get();
+    Game* game                        = Game::getInstance();
+
     // Generate chunks around players
     m_reg.view<PlayerComponent, Object>().each([=](auto& obj) {
         constexpr int xDir[] = {0, -1, 0, 1, -1, 1, -1, 0, 1};
@@ -184,16 +278,37 @@ void Map::simulateWorld(const float dt) {
             const unsigned int yPos =
                 getChunkPos(obj.getPosition()).y + yDir[i];
 
+            if (xPos >= CHUNK_NO || yPos >= CHUNK_NO) {
+                continue;
+            }
+
             if (getChunk(xPos, yPos) == nullptr) {
+                // The chunk under the player is always needed for
+                // collisions, the surrounding ones can wait a tick
+                if (i != 0 && game->isTickOverBudget()) {
+                    game->deferWork();
+                    continue;
+                }
+
                 generateChunk(xPos, yPos);
             }
         }
     });
 
-    // Update animations
-    m_reg.view<AnimationComponent>().each([=](auto& ac) {
-        ac.update(dt);
-    });
+    m_ticks.update();
+    m_fluids.update();
+    steerEntities();
+    m_items.update(m_reg);
+
+    // Update animations, only the players' can't wait
+    const bool deferred = game->isTickOverBudget();
+    if (deferred) {
+        game->deferWork();
+    }
+    AnimationSystem::update(m_reg, deferred);
+
+    tickUpdates.set(static_cast<std::int64_t>(tileUpdates.get() -
+                                              updatesBefore));
 }
 
 void Map::placeTile(Tile* tile, unsigned int xPos, unsigned int yPos) {
@@ -205,6 +320,8 @@ void Map::placeTile(Tile* tile, unsigned int xPos, unsigned int yPos) {
     if (c != nullptr) {
         c->setTile(tile, chunkX, chunkY);
         updateTile(xPos, yPos);
+        m_flow.invalidateTile(xPos, yPos);
+        m_fluids.invalidateTile(xPos, yPos);
     }
 }
 
@@ -251,4 +368,88 @@ void Map::updateTile(sf::Vector2u pos) {
     updateTile(pos.x, pos.y);
 }
 
+void Map::refreshTexture(const sf::Texture* texture) {
+    unsigned int refreshed = 0;
+    for (Chunk* c : m_loaded) {
+        bool uses = false;
+        for (unsigned int y = 0; y < Chunk::CHUNK_SIZE && !uses; y++) {
+            for (unsigned int x = 0; x < Chunk::CHUNK_SIZE && !uses; x++) {
+                uses = c->getTile(x, y).getTexture() == texture;
+            }
+        }
+
+        if (uses) {
+            c->setDirty();
+            refreshed++;
+        }
+    }
+
+    spdlog::debug("Redrawing {} of {} chunks", refreshed, m_loaded.size());
+}
+
+void Map::refreshTile(Tile* tile) {
+    const std::string name = tile->getName();
+    for (Chunk* c : m_loaded) {
+        const sf::Vector2u cp = c->getPosition();
+        for (unsigned int y = 0; y < Chunk::CHUNK_SIZE; y++) {
+            for (unsigned int x = 0; x < Chunk::CHUNK_SIZE; x++) {
+                if (c->getTile(x, y).getName() == name) {
+                    placeTile(tile, cp.x * Chunk::CHUNK_SIZE + x,
+                              cp.y * Chunk::CHUNK_SIZE + y);
+                }
+            }
+        }
+    }
+}
+
+void Map::steerEntities() {
+    NC_PROFILE_FUNCTION();
+
+    // Players are the shared goals, every entity heading to one reads the
+    // same fields
+    m_players.clear();
+    m_reg.view<PlayerComponent, Object>().each([&](auto e, auto& obj) {
+        const sf::Vector2f pos = getFootPosition(m_reg, e, obj);
+        m_flow.setGoal(entt::to_integral(e), sf::Vector2u(pos));
+        m_players.emplace_back(e, pos);
+    });
+    if (m_players.empty()) {
+        return;
+    }
+
+    m_reg.view<SteeringComponent, VelocityComponent, Object,
+               const LodComponent>()
+        .each([&](auto e, auto& steer, auto& vel, auto& obj,
+                  const auto& lod) {
+            // Only needed on the ticks the entity is moved
+            if (lod.step == 0.0f) {
+                return;
+            }
+
+            const sf::Vector2f pos = getFootPosition(m_reg, e, obj);
+            entt::entity goal      = entt::null;
+            float nearest          = std::numeric_limits<float>::max();
+            for (const auto& [player, p] : m_players) {
+                const sf::Vector2f d = p - pos;
+                if (d.x * d.x + d.y * d.y < nearest) {
+                    nearest = d.x * d.x + d.y * d.y;
+                    goal    = player;
+                }
+            }
+
+            const sf::Vector2i dir = m_flow.getDirection(
+                entt::to_integral(goal), sf::Vector2u(pos));
+            vel.velocity = sf::Vector2f(dir) * steer.speed;
+
+            // Keep to the middle of the lane so one tile gaps fit
+            if (dir.x != 0) {
+                vel.velocity.y =
+                    (std::floor(pos.y) + 0.5f - pos.y) * steer.speed;
+            } else if (dir.y != 0) {
+                vel.velocity.x =
+                    (std::floor(pos.x) + 0.5f - pos.x) * steer.speed;
+            }
+        });
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <World/SimulationLod.hpp>
+#include <Components/LodComponent.hpp>
+#include <Components/PlayerComponent.hpp>
+#include <General/Object.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace nc {
+
+SimulationLod::SimulationLod() : m_time(0.0), m_tick(0) {}
+
+void SimulationLod::update(entt::registry& reg, const float dt) {
+    NC_PROFILE_FUNCTION();
+    m_time += dt;
+
+    // Entities spawned since the last tick are near until retiered
+    m_new.clear();
+    for (const entt::entity e :
+         reg.view<Object>(entt::exclude<LodComponent>)) {
+        m_new.push_back(e);
+    }
+    LodComponent lod;
+    lod.lastStep = m_time - dt;
+    reg.insert<LodComponent>(m_new.begin(), m_new.end(), lod);
+
+    if (m_tick % REFRESH_INTERVAL == 0) {
+        assignTiers(reg);
+    }
+
+    reg.view<LodComponent>().each([this](auto e, auto& lod) {
+        if ((m_tick + entt::to_integral(e)) % TIER_INTERVAL[lod.tier] != 0) {
+            lod.step = 0.0f;
+            return;
+        }
+
+        lod.step     = static_cast<float>(m_time - lod.lastStep);
+        lod.lastStep = m_time;
+    });
+
+    m_tick++;
+}
+
+void SimulationLod::assignTiers(entt::registry& reg) {
+    NC_PROFILE_FUNCTION();
+    static Gauge* tierGauges[TIER_NO] = {
+        &Metrics::getGauge("lod.near_entities"),
+        &Metrics::getGauge("lod.mid_entities"),
+        &Metrics::getGauge("lod.far_entities")};
+    static Gauge& visibleGauge = Metrics::getGauge("lod.visible_entities");
+
+    m_players.clear();
+    m_views.clear();
+    reg.view<PlayerComponent, Object>().each([&](auto e, auto& obj) {
+        m_players.push_back(obj.getPosition());
+        if (sf::View** v = reg.try_get<sf::View*>(e); v != nullptr) {
+            const sf::Vector2f size = (*v)->getSize();
+            const sf::Vector2f corner =
+                (*v)->getCenter() - size / 2.0f -
+                sf::Vector2f(VIEW_MARGIN, VIEW_MARGIN);
+            const sf::Vector2f margin(VIEW_MARGIN * 2.0f, VIEW_MARGIN * 2.0f);
+            m_views.emplace_back(corner, size + margin);
+        }
+    });
+
+    std::int64_t counts[TIER_NO] = {};
+    std::int64_t visible         = 0;
+    reg.view<LodComponent, Object>().each([&](auto& lod, auto& obj) {
+        const sf::Vector2f pos = obj.getPosition();
+        float nearest          = std::numeric_limits<float>::max();
+        for (const sf::Vector2f& p : m_players) {
+            const sf::Vector2f d = pos - p;
+            nearest              = std::min(nearest, d.x * d.x + d.y * d.y);
+        }
+
+        std::uint8_t tier = 0;
+        while (tier < TIER_NO - 1 &&
+               nearest > TIER_DISTANCE[tier] * TIER_DISTANCE[tier]) {
+            tier++;
+        }
+
+        // Without a view, only the near tier could be on screen
+        lod.tier    = tier;
+        lod.visible = m_views.empty()
+                          ? tier == 0
+                          : std::any_of(m_views.begin(), m_views.end(),
+                                        [pos](const sf::FloatRect& r) {
+                                            return r.contains(pos);
+                                        });
+        counts[tier]++;
+        visible += lod.visible;
+    });
+
+    for (unsigned int i = 0; i < TIER_NO; i++) {
+        tierGauges[i]->set(counts[i]);
+    }
+    visibleGauge.set(visible);
+}
+
+}
@@ -15,6 +15,8 @@
 #include <World/Tile.hpp>
 #include <World/Map.hpp>
 #include <Game/Game.hpp>
+#include <Game/GameRegistry.hpp>
+#include <General/Metrics.hpp>
 
 namespace {
 
@@ -66,17 +68,22 @@ sf::IntRect Tile::m_textureRects[16] = {
 
 Tile::Tile(const std::string& name)
     : sf::Sprite(), m_name(name), m_hasCollision(false),
-      m_collisionBox(0.0f, 0.0f, 0.0f, 0.0f) {
+      m_collisionBox(0.0f, 0.0f, 0.0f, 0.0f), m_behaviour(nullptr) {
     setTexture("default");
 }
 
 Tile::Tile(const std::string& texture, const std::string& name)
     : sf::Sprite(), m_name(name), m_hasCollision(false),
-      m_collisionBox(0.0f, 0.0f, 0.0f, 0.0f) {
+      m_collisionBox(0.0f, 0.0f, 0.0f, 0.0f), m_behaviour(nullptr) {
     setTexture(texture);
 }
 
 void Tile::setTexture(const std::string& texture) {
+    if (Game::getInstance()->isHeadless()) {
+        m_size = TextureAtlas::TILE_SIZE;
+        return;
+    }
+
     sf::Sprite::setTexture(
         Game::getInstance()->getTextureAtlas().getTexture(texture));
     sf::Sprite::setTextureRect(sf::IntRect(16, 16, 16, 16));
@@ -88,6 +95,9 @@ unsigned int Tile::getSize() const {
 }
 
 void Tile::update(unsigned int posX, unsigned int posY, Map* currentMap) {
+    static Counter& updates = Metrics::getCounter("map.tile_updates");
+    updates.add();
+
     constexpr int xDir[] = {0, 0, -1, 1};
     constexpr int yDir[] = {-1, 1, 0, 0};
     bool connected[]     = {false, false, false, false};
@@ -139,5 +149,16 @@ const sf::FloatRect& Tile::getCollisionBox() {
     return m_collisionBox;
 }
 
+void Tile::setBehaviour(const TileBehaviour* behaviour) {
+    m_behaviour = behaviour;
+}
+
+const TileBehaviour* Tile::getBehaviour() const {
+    return m_behaviour;
+}
+
+bool Tile::hasRandomTick() const {
+    return m_behaviour != nullptr && m_behaviour->randomTick;
+}
 
 }
@@ -0,0 +1,140 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <World/TileTicks.hpp>
+#include <World/Map.hpp>
+#include <World/Chunk.hpp>
+#include <Game/GameRegistry.hpp>
+#include <General/Profiler.hpp>
+#include <General/Metrics.hpp>
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+
+namespace nc {
+
+TileTicks::TileTicks(Map& map) : m_map(map), m_wheel(WHEEL_SLOTS) {}
+
+void TileTicks::setSeed(const std::uint32_t seed) {
+    m_rng.seed(seed);
+}
+
+void TileTicks::schedule(const unsigned int x, const unsigned int y,
+                         const std::uint64_t delay) {
+    const std::uint64_t due =
+        m_wheel.getTick() + std::max<std::uint64_t>(delay, 1);
+    const std::uint64_t key = getKey(x, y);
+
+    auto [it, added] = m_pending.try_emplace(key, due);
+    if (!added) {
+        if (it->second <= due) {
+            return;
+        }
+        // The later timer is left in the wheel and ignored when it fires
+        it->second = due;
+    }
+    m_wheel.schedule(due - m_wheel.getTick(), key);
+}
+
+void TileTicks::update() {
+    NC_PROFILE_FUNCTION();
+    static Counter& randomTicks = Metrics::getCounter("ticks.random");
+    static Counter& scheduled   = Metrics::getCounter("ticks.scheduled");
+    static Gauge& pending       = Metrics::getGauge("ticks.pending");
+    static Histogram& chunkCost = Metrics::getHistogram("ticks.chunk_time");
+    static Gauge& slowest       = Metrics::getGauge("ticks.slowest_chunk_us");
+
+    const std::vector<Chunk*>& loaded = m_map.getLoadedChunks();
+
+    // Ticks may generate chunks, so the list is walked by index
+    for (std::size_t i = 0; i < loaded.size(); i++) {
+        if (loaded[i]->getRandomTicked() != 0) {
+            randomTick(loaded[i]);
+            randomTicks.add(RANDOM_TICKS);
+        }
+    }
+
+    m_wheel.advance([&](const std::uint64_t key) {
+        if (auto it = m_pending.find(key);
+            it != m_pending.end() && it->second == m_wheel.getTick()) {
+            m_pending.erase(it);
+            scheduledTick(key);
+            scheduled.add();
+        }
+    });
+
+    // Only chunks that ran a tick are sampled, with their time this tick
+    std::sort(m_ticked.begin(), m_ticked.end());
+    m_ticked.erase(std::unique(m_ticked.begin(), m_ticked.end()),
+                   m_ticked.end());
+    float worst = 0.0f;
+    for (Chunk* c : m_ticked) {
+        chunkCost.record(c->commitTickTime());
+        worst = std::max(worst, c->getTickCost());
+    }
+    m_ticked.clear();
+    pending.set(static_cast<std::int64_t>(m_pending.size()));
+    slowest.set(static_cast<std::int64_t>(worst * 1e6f));
+}
+
+std::uint64_t TileTicks::getKey(const unsigned int x, const unsigned int y) {
+    return static_cast<std::uint64_t>(y) << 32 | x;
+}
+
+void TileTicks::randomTick(Chunk* chunk) {
+    constexpr unsigned int tileMask = Chunk::CHUNK_SIZE * Chunk::CHUNK_SIZE - 1;
+    static_assert((tileMask & (tileMask + 1)) == 0,
+                  "Tiles are sampled with a mask");
+    const sf::Vector2u cp = chunk->getPosition();
+    sf::Clock clock;
+
+    for (unsigned int i = 0; i < RANDOM_TICKS; i++) {
+        const unsigned int tile = static_cast<unsigned int>(m_rng()) & tileMask;
+        const unsigned int x    = tile % Chunk::CHUNK_SIZE;
+        const unsigned int y    = tile / Chunk::CHUNK_SIZE;
+        const TileBehaviour* b  = chunk->getTile(x, y).getBehaviour();
+        if (b != nullptr && b->randomTick) {
+            b->randomTick(m_map, cp.x * Chunk::CHUNK_SIZE + x,
+                          cp.y * Chunk::CHUNK_SIZE + y);
+        }
+    }
+
+    addTickTime(chunk, clock.getElapsedTime().asSeconds());
+}
+
+void TileTicks::scheduledTick(const std::uint64_t key) {
+    const auto x = static_cast<unsigned int>(key);
+    const auto y = static_cast<unsigned int>(key >> 32);
+
+    // Ticks of chunks that are gone are dropped
+    Chunk* chunk = m_map.getChunk(Map::getChunkPos(x, y));
+    if (chunk == nullptr) {
+        return;
+    }
+
+    const TileBehaviour* b =
+        chunk->getTile(x % Chunk::CHUNK_SIZE, y % Chunk::CHUNK_SIZE)
+            .getBehaviour();
+    if (b != nullptr && b->scheduledTick) {
+        sf::Clock clock;
+        b->scheduledTick(m_map, x, y);
+        addTickTime(chunk, clock.getElapsedTime().asSeconds());
+    }
+}
+
+void TileTicks::addTickTime(Chunk* chunk, const float seconds) {
+    chunk->addTickTime(seconds);
+    m_ticked.push_back(chunk);
+}
+
+}
@@ -0,0 +1,266 @@
+// Copyright 2021 Sirbu Dan
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compiles a data directory (textures, tiles, items, animations, prefabs)
+// into an asset pack the game can map and use without decoding anything.
+
+#include <General/AssetPack.hpp>
+#include <General/AssetDefs.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class StringTable {
+public:
+    std::uint32_t add(const std::string& str) {
+        const auto it = m_offsets.find(str);
+        if (it != m_offsets.end()) {
+            return it->second;
+        }
+
+        const auto offset = static_cast<std::uint32_t>(m_data.size());
+        m_data.append(str);
+        m_data.push_back('\0');
+        m_offsets.emplace(str, offset);
+        return offset;
+    }
+
+    const std::string& getData() const {
+        return m_data;
+    }
+
+private:
+    std::string m_data;
+    std::unordered_map<std::string, std::uint32_t> m_offsets;
+};
+
+std::vector<fs::path> listFiles(const fs::path& dir) {
+    std::vector<fs::path> files;
+    if (fs::is_directory(dir)) {
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Same parsers as the game, so the pack and loose files accept the same
+// definitions
+template <typename Def>
+Def readDef(const fs::path& path,
+            bool (*parse)(const char*, std::size_t, const std::string&, Def&)) {
+    std::ifstream i(path, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(i)),
+                           std::istreambuf_iterator<char>());
+    Def def;
+    if (!parse(data.data(), data.size(), path.string(), def)) {
+        throw std::runtime_error("Invalid definition " + path.string());
+    }
+
+    return def;
+}
+
+std::uint64_t align(const std::uint64_t offset) {
+    const std::uint64_t a = nc::AssetPack::ALIGNMENT;
+    return (offset + a - 1) / a * a;
+}
+
+void pad(std::ofstream& o, const std::uint64_t offset) {
+    const auto at = static_cast<std::uint64_t>(o.tellp());
+    for (std::uint64_t i = at; i < offset; i++) {
+        o.put('\0');
+    }
+}
+
+template <typename T>
+void writeTable(std::ofstream& o, const std::uint64_t offset,
+                const std::vector<T>& table) {
+    pad(o, offset);
+    o.write(reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(table.size() * sizeof(T)));
+}
+
+void bake(const fs::path& input, const fs::path& output) {
+    StringTable strings;
+    std::vector<nc::PackTexture> textures;
+    std::vector<sf::Image> images;
+    std::vector<nc::PackTile> tiles;
+    std::vector<nc::PackItem> items;
+    std::vector<nc::PackClip> clips;
+    std::vector<nc::PackPrefab> prefabs;
+
+    for (const fs::path& p : listFiles(input / "textures")) {
+        sf::Image img;
+        if (!img.loadFromFile(p.string())) {
+            throw std::runtime_error("Could not decode " + p.string());
+        }
+
+        nc::PackTexture t{};
+        // Same key the texture atlas uses for files loaded from PHYSFS
+        t.name   = strings.add("/textures/" + p.filename().string());
+        t.width  = img.getSize().x;
+        t.height = img.getSize().y;
+        textures.push_back(t);
+        images.push_back(std::move(img));
+    }
+
+    for (const fs::path& p : listFiles(input / "tiles")) {
+        const nc::TileDef def = readDef(p, &nc::parseTileDef);
+        nc::PackTile t{};
+        t.name       = strings.add(def.name);
+        t.texture    = strings.add(def.texture);
+        t.collidable = def.collidable ? 1 : 0;
+        tiles.push_back(t);
+    }
+
+    for (const fs::path& p : listFiles(input / "items")) {
+        const nc::ItemDef def = readDef(p, &nc::parseItemDef);
+        nc::PackItem i{};
+        i.name      = strings.add(def.name);
+        i.texture   = strings.add(def.texture);
+        i.placeTile = def.placeTile.empty() ? nc::AssetPack::NO_STRING
+                                            : strings.add(def.placeTile);
+        items.push_back(i);
+    }
+
+    for (const fs::path& p : listFiles(input / "animations")) {
+        const nc::AnimationSetDef def = readDef(p, &nc::parseAnimationSetDef);
+        for (const nc::AnimationClipDef& c : def.clips) {
+            nc::PackClip clip{};
+            clip.name        = strings.add(def.name + '.' + c.name);
+            clip.x           = c.x;
+            clip.y           = c.y;
+            clip.frameWidth  = static_cast<std::uint32_t>(def.frameWidth);
+            clip.frameHeight = static_cast<std::uint32_t>(def.frameHeight);
+            clip.frames      = c.frames;
+            clip.frameTime   = 1.0f / def.framerate;
+            clip.repeated    = c.repeated ? 1 : 0;
+            clips.push_back(clip);
+        }
+    }
+
+    for (const fs::path& p : listFiles(input / "prefabs")) {
+        const nc::PrefabDef def = readDef(p, &nc::parsePrefabDef);
+        nc::PackPrefab pf{};
+        pf.name          = strings.add(def.name);
+        pf.texture       = strings.add(def.texture);
+        pf.clip          = def.clip.empty() ? nc::AssetPack::NO_STRING
+                                            : strings.add(def.clip);
+        pf.components    = def.components;
+        pf.width         = def.width;
+        pf.height        = def.height;
+        pf.inventorySize = def.inventorySize;
+        pf.steeringSpeed = def.steeringSpeed;
+        pf.boxX          = def.boxX;
+        pf.boxY          = def.boxY;
+        pf.boxWidth      = def.boxWidth;
+        pf.boxHeight     = def.boxHeight;
+        prefabs.push_back(pf);
+    }
+
+    if (strings.getData().empty()) {
+        strings.add("");
+    }
+
+    // Lay out the tables, then the pixel data of every texture
+    nc::PackHeader h{};
+    h.magic         = nc::AssetPack::MAGIC;
+    h.version       = nc::AssetPack::VERSION;
+    h.textureNo     = static_cast<std::uint32_t>(textures.size());
+    h.tileNo        = static_cast<std::uint32_t>(tiles.size());
+    h.itemNo        = static_cast<std::uint32_t>(items.size());
+    h.clipNo        = static_cast<std::uint32_t>(clips.size());
+    h.prefabNo      = static_cast<std::uint32_t>(prefabs.size());
+    h.stringSize    = static_cast<std::uint32_t>(strings.getData().size());
+    h.textureOffset = align(sizeof(nc::PackHeader));
+    h.tileOffset =
+        align(h.textureOffset + textures.size() * sizeof(nc::PackTexture));
+    h.itemOffset = align(h.tileOffset + tiles.size() * sizeof(nc::PackTile));
+    h.clipOffset = align(h.itemOffset + items.size() * sizeof(nc::PackItem));
+    h.prefabOffset =
+        align(h.clipOffset + clips.size() * sizeof(nc::PackClip));
+    h.stringOffset =
+        align(h.prefabOffset + prefabs.size() * sizeof(nc::PackPrefab));
+
+    std::uint64_t end = h.stringOffset + h.stringSize;
+    for (nc::PackTexture& t : textures) {
+        t.pixels = align(end);
+        end      = t.pixels +
+                   static_cast<std::uint64_t>(t.width) * t.height * 4;
+    }
+
+    fs::create_directories(output.parent_path().empty()
+                               ? fs::path(".")
+                               : output.parent_path());
+    std::ofstream o(output, std::ios::binary | std::ios::trunc);
+    if (!o) {
+        throw std::runtime_error("Could not open " + output.string());
+    }
+
+    o.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    writeTable(o, h.textureOffset, textures);
+    writeTable(o, h.tileOffset, tiles);
+    writeTable(o, h.itemOffset, items);
+    writeTable(o, h.clipOffset, clips);
+    writeTable(o, h.prefabOffset, prefabs);
+    pad(o, h.stringOffset);
+    o.write(strings.getData().data(), h.stringSize);
+    for (std::size_t i = 0; i < textures.size(); i++) {
+        pad(o, textures[i].pixels);
+        o.write(reinterpret_cast<const char*>(images[i].getPixelsPtr()),
+                static_cast<std::streamsize>(textures[i].width *
+                                             textures[i].height * 4));
+    }
+
+    if (!o) {
+        throw std::runtime_error("Could not write " + output.string());
+    }
+
+    spdlog::info("Baked {} textures, {} tiles, {} items, {} animation clips "
+                 "and {} prefabs into {} ({} bytes)",
+                 textures.size(), tiles.size(), items.size(), clips.size(),
+                 prefabs.size(), output.string(), end);
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        spdlog::error("Usage: nanocraft-bake <data directory> <output pack>");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        bake(argv[1], argv[2]);
+    } catch (const std::exception& e) {
+        spdlog::error("{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}